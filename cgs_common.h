@@ -1,10 +1,120 @@
 #ifndef CGS_COMMON_H
 #define CGS_COMMON_H
 
+#include <stdint.h>
+#include <stdlib.h>
+
 #define CGS_CAT_HELPER(a, b) a##b
 #define CGS_CAT_HELPER2(a, b) CGS_CAT_HELPER(a##_, b)
 #define CGS_CAT_HELPER3(a, b) CGS_CAT_HELPER2(cgs_internal_##a, b)
 #define CGS_CAT(a, b) CGS_CAT_HELPER2(a, b)
 #define CGS_CAT_INTERNAL(a, b) CGS_CAT_HELPER3(a, b)
 
+/*
+ * Global allocator hooks, used by every container unless overridden per instantiation.
+ * To replace them, define them before the first cgs header is included.
+ * - ctx: The allocator context pointer stored in the container. (NULL unless given with new_with_ctx())
+ * - size, old_size: The sizes of the allocations in bytes.
+ */
+#ifndef CGS_MALLOC
+#define CGS_MALLOC(ctx, size) ((void) (ctx), malloc(size))
+#endif
+#ifndef CGS_REALLOC
+#define CGS_REALLOC(ctx, ptr, old_size, size) ((void) (ctx), realloc(ptr, size))
+#endif
+#ifndef CGS_FREE
+#define CGS_FREE(ctx, ptr, size) ((void) (ctx), free(ptr))
+#endif
+
+/* The assumed size of a cache line, used to keep data shared between threads apart. */
+#define CGS_CACHE_LINE 64
+
+/* Aligns a type or a variable. */
+#if defined(__GNUC__) || defined(__clang__)
+#define CGS_ALIGNED(n) __attribute__((aligned(n)))
+#elif defined(_MSC_VER)
+#define CGS_ALIGNED(n) __declspec(align(n))
+#else
+#define CGS_ALIGNED(n)
+#endif
+
+/* Hint that the thread is busy-waiting. */
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define CGS_CPU_RELAX() __builtin_ia32_pause()
+#else
+#define CGS_CPU_RELAX() ((void) 0)
+#endif
+
+/* Hint that the memory at ptr will be accessed soon. */
+#if defined(__GNUC__) || defined(__clang__)
+#define CGS_PREFETCH(ptr) __builtin_prefetch(ptr)
+#else
+#define CGS_PREFETCH(ptr) ((void) (ptr))
+#endif
+
+/**
+ * @brief Count the trailing zero bits of a 32-bit integer.
+ * @param x The integer to scan. Must not be zero.
+ * @return The index of the lowest set bit.
+ */
+static inline unsigned cgs_ctz32(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned) __builtin_ctz(x);
+#else
+    unsigned n = 0;
+    while (!(x & 1)) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief Count the leading zero bits of a 32-bit integer.
+ * @param x The integer to scan. Must not be zero.
+ * @return 31 minus the index of the highest set bit.
+ */
+static inline unsigned cgs_clz32(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned) __builtin_clz(x);
+#else
+    unsigned n = 0;
+    while (!(x & 0x80000000u)) {
+        x <<= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
+/**
+ * @brief Count the leading zero bits of a 64-bit integer.
+ * @param x The integer to scan. Must not be zero.
+ * @return 63 minus the index of the highest set bit.
+ */
+static inline unsigned cgs_clz64(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned) __builtin_clzll(x);
+#else
+    return x >> 32 ? cgs_clz32((uint32_t) (x >> 32)) : 32 + cgs_clz32((uint32_t) x);
+#endif
+}
+
+/**
+ * @brief Count the set bits of a 32-bit integer.
+ * @param x The integer to count.
+ * @return The number of set bits.
+ */
+static inline unsigned cgs_popcount32(uint32_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned) __builtin_popcount(x);
+#else
+    x = x - ((x >> 1) & 0x55555555u);
+    x = (x & 0x33333333u) + ((x >> 2) & 0x33333333u);
+    x = (x + (x >> 4)) & 0x0f0f0f0fu;
+    return (x * 0x01010101u) >> 24;
+#endif
+}
+
 #endif
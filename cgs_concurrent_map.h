@@ -0,0 +1,312 @@
+/**
+ * @file cgs_concurrent_map.h
+ * @brief A thread-safe unordered map, split into independently locked shards.
+ *
+ * Each shard is a map generated with cgs_map.h, protected by its own lock. The shard of a key is chosen with
+ * the high bits of its hash, and the shard maps use the low bits, so buckets are only split within a shard.
+ * Operations on keys in different shards never wait for each other.
+ *
+ * Define the following macros before including the header.
+ * - cgs_cmap_name: Required. The name of the generated map type. (e.g. `my_map`)
+ * - cgs_map_key, cgs_map_value and one of the hashing macros: Required, as in cgs_map.h.
+ *   A manually defined hash function must be named `cgs_internal_<cgs_cmap_name>_map_hash`.
+ * - cgs_cmap_shards: Optional. The number of shards. (Default: 64)
+ * - cgs_cmap_spinlock: Optional. If defined, the shards are protected with spinlocks instead of pthread
+ *   read-write locks. Spinlocks are cheaper for short operations, but readers also exclude each other.
+ *   Without it, strict ISO C modes need `_POSIX_C_SOURCE` to be at least 200112L for `pthread_rwlock_t`.
+ * - cgs_cmap_malloc(ctx, size), cgs_cmap_free(ctx, ptr, size): Optional. Replace the global allocator hooks
+ *   of cgs_common.h for the shard array.
+ *
+ * The other macros of cgs_map.h (e.g. `cgs_map_load_factor`, `cgs_map_pooled`) apply to every shard.
+ * `cgs_map_name` must not be defined.
+ *
+ * The hash function should spread keys over its high bits, so `cgs_map_int_hash_identity` is not recommended.
+ *
+ * After the header is included, define the macro `cgs_<cgs_cmap_name>` to 1.
+ * This is to prevent clashes from multiple includes.
+ *
+ * For example, the following code generates the type `llcmap` with `int64_t`->`int64_t` key-value types.
+ * ```
+ * #define cgs_map_key int64_t
+ * #define cgs_map_value int64_t
+ * #define cgs_map_default_hash
+ * #define cgs_cmap_name llcmap
+ * #include "cgs_concurrent_map.h"
+ * #define cgs_llcmap 1
+ * ```
+ */
+
+#include "cgs_common.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#ifndef cgs_cmap_spinlock
+#include <pthread.h>
+#endif
+
+/* Common functions (include only once) */
+#ifndef CGS_CONCURRENT_MAP_H
+#define CGS_CONCURRENT_MAP_H
+
+/**
+ * @brief Acquire a spinlock.
+ * @param lock The lock to acquire. 0 if unlocked, 1 if locked.
+ */
+static inline void cgs_cmap_spin_lock(int *lock) {
+    while (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        /* wait without writing, so that the cache line is not bounced between waiting threads */
+        while (__atomic_load_n(lock, __ATOMIC_RELAXED)) {
+            CGS_CPU_RELAX();
+        }
+    }
+}
+
+/**
+ * @brief Release a spinlock.
+ * @param lock The lock to release.
+ */
+static inline void cgs_cmap_spin_unlock(int *lock) {
+    __atomic_store_n(lock, 0, __ATOMIC_RELEASE);
+}
+
+#define CGS_CMAP(name) CGS_CAT(cgs_cmap_name, name)
+#define CGS_CMAP_INTERNAL(name) CGS_CAT_INTERNAL(cgs_cmap_name, name)
+#define CGS_CMAP_SHARD(name) CGS_CAT(CGS_CMAP_INTERNAL(map), name)
+#define CGS_CMAP_SHARD_INTERNAL(name) CGS_CAT_INTERNAL(CGS_CMAP_INTERNAL(map), name)
+
+#endif
+
+/* semi include guard */
+#if !CGS_CAT(cgs, cgs_cmap_name)
+
+#ifndef cgs_cmap_shards
+#define cgs_cmap_shards 64
+#endif
+
+#ifndef cgs_cmap_malloc
+#define cgs_cmap_malloc CGS_MALLOC
+#endif
+#ifndef cgs_cmap_free
+#define cgs_cmap_free CGS_FREE
+#endif
+
+#ifndef cgs_map_default_value
+#define cgs_map_default_value 0
+#endif
+
+typedef cgs_map_key CGS_CMAP(key);
+typedef cgs_map_value CGS_CMAP(value);
+
+/** @private Returns the value of `cgs_map_default_value`, which is undefined by cgs_map.h. */
+static inline cgs_map_value CGS_CMAP_INTERNAL(default_value)(void) {
+    return cgs_map_default_value;
+}
+
+#define cgs_map_name CGS_CMAP_INTERNAL(map)
+#include "cgs_map.h"
+
+/** A shard, aligned to a cache line so that locking one shard does not slow down its neighbors. */
+typedef struct CGS_ALIGNED(CGS_CACHE_LINE) CGS_CMAP(shard) {
+#ifdef cgs_cmap_spinlock
+    int lock;
+#else
+    pthread_rwlock_t lock;
+#endif
+    CGS_CMAP_INTERNAL(map) map;
+} CGS_CMAP(shard);
+
+typedef struct {
+    CGS_CMAP(shard) shards[cgs_cmap_shards];
+    void *alloc_ctx;
+    void *raw; /* the allocation that holds this map, which may not be aligned */
+} cgs_cmap_name;
+
+/**
+ * @brief Allocates and initializes a new map that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized map.
+ */
+static inline cgs_cmap_name *CGS_CMAP(new_with_ctx)(void *ctx) {
+    void *raw = cgs_cmap_malloc(ctx, sizeof(cgs_cmap_name) + CGS_CACHE_LINE - 1);
+    cgs_cmap_name *m = (cgs_cmap_name *) (((uintptr_t) raw + CGS_CACHE_LINE - 1) & ~(uintptr_t) (CGS_CACHE_LINE - 1));
+    m->raw = raw;
+    m->alloc_ctx = ctx;
+    for (size_t i = 0; i < cgs_cmap_shards; i++) {
+#ifdef cgs_cmap_spinlock
+        m->shards[i].lock = 0;
+#else
+        pthread_rwlock_init(&m->shards[i].lock, NULL);
+#endif
+        CGS_CMAP_SHARD(init)(&m->shards[i].map, ctx);
+    }
+    return m;
+}
+
+/**
+ * @brief Allocates and initializes a new map.
+ * @return A newly allocated and initialized map.
+ */
+static inline cgs_cmap_name *CGS_CMAP(new)() {
+    return CGS_CMAP(new_with_ctx)(NULL);
+}
+
+/** @private Returns the shard responsible for the given hash. */
+static inline CGS_CMAP(shard) *CGS_CMAP_INTERNAL(shard_of)(cgs_cmap_name *m, uint32_t hash) {
+    return &m->shards[((uint64_t) hash * cgs_cmap_shards) >> 32];
+}
+
+/** @private Locks a shard for reading. */
+static inline void CGS_CMAP_INTERNAL(lock_read)(CGS_CMAP(shard) *s) {
+#ifdef cgs_cmap_spinlock
+    cgs_cmap_spin_lock(&s->lock);
+#else
+    pthread_rwlock_rdlock(&s->lock);
+#endif
+}
+
+/** @private Locks a shard for writing. */
+static inline void CGS_CMAP_INTERNAL(lock_write)(CGS_CMAP(shard) *s) {
+#ifdef cgs_cmap_spinlock
+    cgs_cmap_spin_lock(&s->lock);
+#else
+    pthread_rwlock_wrlock(&s->lock);
+#endif
+}
+
+/** @private Unlocks a shard. */
+static inline void CGS_CMAP_INTERNAL(unlock)(CGS_CMAP(shard) *s) {
+#ifdef cgs_cmap_spinlock
+    cgs_cmap_spin_unlock(&s->lock);
+#else
+    pthread_rwlock_unlock(&s->lock);
+#endif
+}
+
+/**
+ * @brief Inserts a key-value pair to the map.
+ * If the key already exists, the existing value is modified.
+ * @param m The map to use.
+ * @param key The key to insert.
+ * @param value The value to insert.
+ */
+static inline void CGS_CMAP(insert)(cgs_cmap_name *m, CGS_CMAP(key) key, CGS_CMAP(value) value) {
+    uint32_t hash = CGS_CMAP_SHARD(hash)(key);
+    CGS_CMAP(shard) *s = CGS_CMAP_INTERNAL(shard_of)(m, hash);
+    CGS_CMAP_INTERNAL(lock_write)(s);
+    CGS_CMAP_SHARD_INTERNAL(insert_hash)(&s->map, hash, key, value);
+    CGS_CMAP_INTERNAL(unlock)(s);
+}
+
+/**
+ * @brief Finds the value associated with the given key.
+ * If the key is not found, returns the default value defined with `cgs_map_default_value`.
+ * @param m The map to use.
+ * @param key The key to find.
+ * @return The value associated with the given key, or the default value.
+ */
+static inline CGS_CMAP(value) CGS_CMAP(find)(cgs_cmap_name *m, CGS_CMAP(key) key) {
+    uint32_t hash = CGS_CMAP_SHARD(hash)(key);
+    CGS_CMAP(shard) *s = CGS_CMAP_INTERNAL(shard_of)(m, hash);
+    CGS_CMAP(value) res;
+    CGS_CMAP_INTERNAL(lock_read)(s);
+    CGS_CMAP_SHARD(entry) *entry = CGS_CMAP_SHARD_INTERNAL(find_entry)(
+            &s->map, CGS_CMAP_SHARD_INTERNAL(normalize_hash)(&s->map, hash), key);
+    res = entry == NULL ? CGS_CMAP_INTERNAL(default_value)() : entry->value;
+    CGS_CMAP_INTERNAL(unlock)(s);
+    return res;
+}
+
+/**
+ * @brief Erases the entry with the given key and returns the value it was associated with.
+ * If the key is not found, returns the default value defined with `cgs_map_default_value`.
+ * @param m The map to use.
+ * @param key The key to erase.
+ * @return The value previously associated with the given key, or the default value.
+ */
+static inline CGS_CMAP(value) CGS_CMAP(erase)(cgs_cmap_name *m, CGS_CMAP(key) key) {
+    uint32_t hash = CGS_CMAP_SHARD(hash)(key);
+    CGS_CMAP(shard) *s = CGS_CMAP_INTERNAL(shard_of)(m, hash);
+    CGS_CMAP(value) res;
+    CGS_CMAP_INTERNAL(lock_write)(s);
+    res = CGS_CMAP_SHARD_INTERNAL(erase_hash)(&s->map, hash, key);
+    CGS_CMAP_INTERNAL(unlock)(s);
+    return res;
+}
+
+/**
+ * @brief Atomically updates the value associated with the given key, inserting it if it does not exist.
+ * The update function is called with the shard locked, so it must not access the map.
+ * @param m The map to use.
+ * @param key The key to update.
+ * @param update Computes the new value from the current value, or from the default value if the key is not found.
+ * @param ctx A pointer passed to the update function.
+ * @return The new value associated with the key.
+ */
+static inline CGS_CMAP(value) CGS_CMAP(upsert)(cgs_cmap_name *m, CGS_CMAP(key) key,
+                                              CGS_CMAP(value) (*update)(CGS_CMAP(value), void *), void *ctx) {
+    uint32_t hash = CGS_CMAP_SHARD(hash)(key);
+    CGS_CMAP(shard) *s = CGS_CMAP_INTERNAL(shard_of)(m, hash);
+    CGS_CMAP(value) res;
+    CGS_CMAP_INTERNAL(lock_write)(s);
+    CGS_CMAP_SHARD(entry) *entry = CGS_CMAP_SHARD_INTERNAL(find_entry)(
+            &s->map, CGS_CMAP_SHARD_INTERNAL(normalize_hash)(&s->map, hash), key);
+    if (entry != NULL) {
+        res = entry->value = update(entry->value, ctx);
+    } else {
+        res = update(CGS_CMAP_INTERNAL(default_value)(), ctx);
+        CGS_CMAP_SHARD_INTERNAL(insert_hash)(&s->map, hash, key, res);
+    }
+    CGS_CMAP_INTERNAL(unlock)(s);
+    return res;
+}
+
+/**
+ * @brief Counts the entries of the map.
+ * The shards are counted one by one, so the result may be outdated if other threads modify the map.
+ * @param m The map to query.
+ * @return The number of entries in the map.
+ */
+static inline size_t CGS_CMAP(size)(cgs_cmap_name *m) {
+    size_t res = 0;
+    for (size_t i = 0; i < cgs_cmap_shards; i++) {
+        CGS_CMAP_INTERNAL(lock_read)(&m->shards[i]);
+        res += m->shards[i].map.size;
+        CGS_CMAP_INTERNAL(unlock)(&m->shards[i]);
+    }
+    return res;
+}
+
+/**
+ * @brief Removes all entries from the map.
+ * The shards are cleared one by one.
+ * @param m The map to use.
+ */
+static inline void CGS_CMAP(clear)(cgs_cmap_name *m) {
+    for (size_t i = 0; i < cgs_cmap_shards; i++) {
+        CGS_CMAP_INTERNAL(lock_write)(&m->shards[i]);
+        CGS_CMAP_SHARD(clear)(&m->shards[i].map);
+        CGS_CMAP_INTERNAL(unlock)(&m->shards[i]);
+    }
+}
+
+/**
+ * @brief Frees the map and all of its data structures.
+ * No other thread may access the map during or after this call.
+ * @param m The map to free.
+ */
+static inline void CGS_CMAP(free)(cgs_cmap_name *m) {
+    for (size_t i = 0; i < cgs_cmap_shards; i++) {
+#ifndef cgs_cmap_spinlock
+        pthread_rwlock_destroy(&m->shards[i].lock);
+#endif
+        CGS_CMAP_SHARD(destroy)(&m->shards[i].map);
+    }
+    cgs_cmap_free(m->alloc_ctx, m->raw, sizeof(cgs_cmap_name) + CGS_CACHE_LINE - 1);
+}
+
+#undef cgs_cmap_name
+#undef cgs_cmap_shards
+#undef cgs_cmap_spinlock
+#undef cgs_cmap_malloc
+#undef cgs_cmap_free
+#endif /* include guard */
@@ -0,0 +1,372 @@
+/**
+ * @file cgs_dense_map.h
+ * @brief An insertion-ordered map, with its entries in a dense array and a separate index table.
+ *
+ * The entries are appended to a vector in insertion order, and an open-addressing table of 32-bit slots
+ * maps the hashes to their positions. Iterating over the map is a linear scan of the entry array, without
+ * any pointers per entry. Erased entries are left in the array as tombstones, and the array is compacted
+ * once the tombstones outnumber the live entries. This suits maps that are scanned far more often than
+ * they are modified.
+ *
+ * The macros are the same as in cgs_map.h.
+ * - cgs_map_name: Required. The name of the generated map type. (e.g. `my_map`)
+ * - cgs_map_key: Required. The type of the key. (e.g. `int`, `char *`)
+ * - cgs_map_value: Required. The type of the value. (e.g. `int`, `char *`)
+ * - cgs_map_initial_capacity: Optional. The initial capacity of the map. (Default: 16)
+ * - cgs_map_default_value: Optional. The default value returned when the element is not found. (Default: 0)
+ * - cgs_map_load_factor: Optional. The maximum load factor of the index table as an integer percentage.
+ *   (Default: 75)
+ * - cgs_map_malloc(ctx, size), cgs_map_realloc(ctx, ptr, old_size, size), cgs_map_free(ctx, ptr, size):
+ *   Optional. Replace the global allocator hooks of cgs_common.h for this map, including its entry array.
+ *
+ * The hashing function is chosen with the `cgs_map_default_hash*` macros, or defined manually,
+ * exactly as in cgs_map.h.
+ *
+ * After the header is included, define the macro `cgs_<cgs_map_name>` to 1.
+ * This is to prevent clashes from multiple includes.
+ *
+ * For example, the following code generates the type `sidmap` with `char *`->`int` key-value types.
+ *
+ * ```
+ * #define cgs_map_key char *
+ * #define cgs_map_value int
+ * #define cgs_map_default_hash_str
+ * #define cgs_map_name sidmap
+ * #include "cgs_dense_map.h"
+ * #define cgs_sidmap 1
+ * ```
+ */
+
+#include "cgs_common.h"
+#include "cgs_hash.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+/* Common macros (include only once) */
+#ifndef CGS_DENSE_MAP_H
+#define CGS_DENSE_MAP_H
+
+/** The stored hash of an erased entry. Live entries only store the low 31 bits of their hash. */
+#define CGS_DENSE_MAP_DEAD 0xffffffffu
+
+/**
+ * @brief Generates a for-each loop over the entries of the map, in insertion order.
+ *
+ * The parameters `k` and `v` are defined inside the macro, so they should not be defined outside.
+ * They hold copies of the key and the value of the current entry.
+ * The map must not be modified inside the loop. `break` and `continue` work as in a plain loop.
+ *
+ * @param t The name of the map type. (e.g. `my_map`)
+ * @param m The map to iterate on.
+ * @param k The variable that holds the current key.
+ * @param v The variable that holds the current value.
+ */
+#define cgs_dense_map_foreach(t, m, k, v) \
+    for (CGS_CAT(t, entry) *k##__e = (m)->entries.array, *k##__end = k##__e + (m)->entries.size, *k##__b = NULL; \
+         k##__e != k##__end; k##__e = k##__b ? k##__end : k##__e + 1) \
+        for (CGS_CAT(t, key) k = k##__e->key, *k##__k = k##__e->hash != CGS_DENSE_MAP_DEAD ? &k : NULL; k##__k; \
+             k##__k = NULL) \
+            for (CGS_CAT(t, value) v = (k##__b = k##__e, k##__e->value); k##__b; k##__b = NULL)
+#define CGS_DENSE_MAP(name) CGS_CAT(cgs_map_name, name)
+#define CGS_DENSE_MAP_INTERNAL(name) CGS_CAT_INTERNAL(cgs_map_name, name)
+
+#endif
+
+/* semi include guard */
+#if !CGS_CAT(cgs, cgs_map_name)
+
+typedef cgs_map_key CGS_DENSE_MAP(key);
+typedef cgs_map_value CGS_DENSE_MAP(value);
+
+#ifndef cgs_map_initial_capacity
+#define cgs_map_initial_capacity 16
+#endif
+
+#ifndef cgs_map_default_value
+#define cgs_map_default_value 0
+#endif
+
+#ifndef cgs_map_load_factor
+#define cgs_map_load_factor 75
+#endif
+
+#ifndef cgs_map_malloc
+#define cgs_map_malloc CGS_MALLOC
+#endif
+#ifndef cgs_map_realloc
+#define cgs_map_realloc CGS_REALLOC
+#endif
+#ifndef cgs_map_free
+#define cgs_map_free CGS_FREE
+#endif
+
+/** An entry of the map. `hash` is CGS_DENSE_MAP_DEAD if the entry was erased. */
+typedef struct CGS_DENSE_MAP(entry) {
+    cgs_map_key key;
+    uint32_t hash;
+    cgs_map_value value;
+} CGS_DENSE_MAP(entry);
+
+#define cgs_vec_type CGS_DENSE_MAP(entry)
+#define cgs_vec_name CGS_DENSE_MAP_INTERNAL(vec)
+#define cgs_vec_equals(a, b) ((a).key == (b).key)
+#define cgs_vec_malloc cgs_map_malloc
+#define cgs_vec_realloc cgs_map_realloc
+#define cgs_vec_free cgs_map_free
+#include "cgs_vector.h"
+
+#define cgs_hash_key cgs_map_key
+#define cgs_hash_name CGS_DENSE_MAP(hash)
+#include "cgs_hash.h"
+
+/*
+ * Each slot of the index table is 0 if it is empty, or the position of an entry plus one.
+ * The table uses linear probing, and erasing shifts the following slots back instead of leaving tombstones,
+ * so only the entry array has tombstones.
+ */
+typedef struct {
+    size_t size; /* the number of live entries */
+    size_t capacity; /* the number of slots in the index table, a power of two */
+    uint32_t *index;
+    CGS_DENSE_MAP_INTERNAL(vec) entries;
+    void *alloc_ctx;
+} cgs_map_name;
+
+/** @private Returns the number of entries a table with the given capacity may hold. */
+static inline size_t CGS_DENSE_MAP_INTERNAL(max_load)(size_t capacity) {
+    size_t res = capacity * cgs_map_load_factor / 100;
+    return res < capacity ? res : capacity - 1; /* keep at least one empty slot to terminate probes */
+}
+
+/** @private Puts the position of an entry in the first empty slot of its probe sequence. */
+static inline void CGS_DENSE_MAP_INTERNAL(link)(cgs_map_name *m, uint32_t hash, size_t pos) {
+    size_t mask = m->capacity - 1, i = hash & mask;
+    while (m->index[i] != 0) {
+        i = (i + 1) & mask;
+    }
+    m->index[i] = (uint32_t) (pos + 1);
+}
+
+/** @private Drops the tombstones from the entry array, and rebuilds an index table with the given capacity. */
+static inline void CGS_DENSE_MAP_INTERNAL(rehash)(cgs_map_name *m, size_t capacity) {
+    CGS_DENSE_MAP(entry) *entries = m->entries.array;
+    size_t live = 0;
+    for (size_t i = 0; i < m->entries.size; i++) {
+        if (entries[i].hash != CGS_DENSE_MAP_DEAD) {
+            entries[live++] = entries[i];
+        }
+    }
+    m->entries.size = live;
+
+    if (capacity != m->capacity) {
+        cgs_map_free(m->alloc_ctx, m->index, m->capacity * sizeof(uint32_t));
+        m->index = cgs_map_malloc(m->alloc_ctx, capacity * sizeof(uint32_t));
+        m->capacity = capacity;
+    }
+    memset(m->index, 0, capacity * sizeof(uint32_t));
+    for (size_t i = 0; i < live; i++) {
+        CGS_DENSE_MAP_INTERNAL(link)(m, entries[i].hash, i);
+    }
+}
+
+/**
+ * @brief Initializes a map in place, e.g. one embedded in another struct or on the stack.
+ * @param m The map to initialize.
+ * @param ctx The context pointer passed to the allocator hooks.
+ */
+static inline void CGS_DENSE_MAP(init)(cgs_map_name *m, void *ctx) {
+    size_t capacity = 8;
+    while (capacity < (cgs_map_initial_capacity)) {
+        capacity *= 2;
+    }
+    m->alloc_ctx = ctx;
+    m->size = 0;
+    m->capacity = capacity;
+    m->index = cgs_map_malloc(ctx, capacity * sizeof(uint32_t));
+    memset(m->index, 0, capacity * sizeof(uint32_t));
+    CGS_DENSE_MAP_INTERNAL(vec_init)(&m->entries, ctx);
+}
+
+/**
+ * @brief Allocates and initializes a new map that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized map.
+ */
+static inline cgs_map_name *CGS_DENSE_MAP(new_with_ctx)(void *ctx) {
+    cgs_map_name *m = cgs_map_malloc(ctx, sizeof(cgs_map_name));
+    CGS_DENSE_MAP(init)(m, ctx);
+    return m;
+}
+
+/**
+ * @brief Allocates and initializes a new map.
+ * @return A newly allocated and initialized map.
+ */
+static inline cgs_map_name *CGS_DENSE_MAP(new)() {
+    return CGS_DENSE_MAP(new_with_ctx)(NULL);
+}
+
+/** @private Finds the index slot of the given key, or returns -1 if it does not exist. */
+static inline size_t CGS_DENSE_MAP_INTERNAL(find_slot)(cgs_map_name *m, uint32_t hash, cgs_map_key key) {
+    size_t mask = m->capacity - 1, i = hash & mask;
+    CGS_DENSE_MAP(entry) *entries = m->entries.array;
+    for (; m->index[i] != 0; i = (i + 1) & mask) {
+        CGS_DENSE_MAP(entry) *entry = &entries[m->index[i] - 1];
+        if (entry->hash == hash && entry->key == key) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Prepares the map to hold at least n entries without growing its index table.
+ * Also reserves room for them in the entry array, and compacts the array.
+ * @param m The map to use.
+ * @param n The number of entries to prepare for.
+ */
+static inline void CGS_DENSE_MAP(reserve)(cgs_map_name *m, size_t n) {
+    size_t capacity = m->capacity;
+    while (CGS_DENSE_MAP_INTERNAL(max_load)(capacity) < n) {
+        capacity *= 2;
+    }
+    if (capacity != m->capacity) {
+        CGS_DENSE_MAP_INTERNAL(rehash)(m, capacity);
+    }
+    CGS_DENSE_MAP_INTERNAL(vec_reserve)(&m->entries, n);
+}
+
+/**
+ * @brief Inserts a key-value pair to the map.
+ * If the key already exists, the existing value is modified, and the entry keeps its position.
+ * @param m The map to use.
+ * @param key The key to insert.
+ * @param value The value to insert.
+ */
+static inline void CGS_DENSE_MAP(insert)(cgs_map_name *m, cgs_map_key key, cgs_map_value value) {
+    uint32_t hash = CGS_DENSE_MAP(hash)(key) & 0x7fffffffu;
+    size_t slot = CGS_DENSE_MAP_INTERNAL(find_slot)(m, hash, key);
+    if (slot != (size_t) -1) {
+        m->entries.array[m->index[slot] - 1].value = value;
+        return;
+    }
+
+    if (m->size + 1 > CGS_DENSE_MAP_INTERNAL(max_load)(m->capacity)) {
+        CGS_DENSE_MAP_INTERNAL(rehash)(m, m->capacity * 2);
+    }
+    assert(m->entries.size < UINT32_MAX);
+
+    CGS_DENSE_MAP(entry) entry;
+    entry.key = key;
+    entry.hash = hash;
+    entry.value = value;
+    CGS_DENSE_MAP_INTERNAL(vec_push_back)(&m->entries, entry);
+    CGS_DENSE_MAP_INTERNAL(link)(m, hash, m->entries.size - 1);
+    m->size++;
+}
+
+/**
+ * @brief Finds the value associated with the given key.
+ * If the key is not found, returns the default value defined with `cgs_map_default_value`.
+ * @param m The map to use.
+ * @param key The key to find.
+ * @return The value associated with the given key, or the default value.
+ */
+static inline cgs_map_value CGS_DENSE_MAP(find)(cgs_map_name *m, cgs_map_key key) {
+    size_t slot = CGS_DENSE_MAP_INTERNAL(find_slot)(m, CGS_DENSE_MAP(hash)(key) & 0x7fffffffu, key);
+    return slot == (size_t) -1 ? (cgs_map_default_value) : m->entries.array[m->index[slot] - 1].value;
+}
+
+/**
+ * @brief Erases the entry with the given key and returns the value it was associated with.
+ * If the key is not found, returns the default value defined with `cgs_map_default_value`.
+ * The entry is left as a tombstone, unless it is the last one. The tombstones are dropped all at once,
+ * when they outnumber the live entries.
+ * @param m The map to use.
+ * @param key The key to erase.
+ * @return The value previously associated with the given key, or the default value.
+ */
+static inline cgs_map_value CGS_DENSE_MAP(erase)(cgs_map_name *m, cgs_map_key key) {
+    size_t slot = CGS_DENSE_MAP_INTERNAL(find_slot)(m, CGS_DENSE_MAP(hash)(key) & 0x7fffffffu, key);
+    if (slot == (size_t) -1) {
+        return cgs_map_default_value;
+    }
+    size_t pos = m->index[slot] - 1, mask = m->capacity - 1;
+    cgs_map_value res = m->entries.array[pos].value;
+
+    /* shift back the following slots that may not be left behind the hole */
+    for (size_t i = (slot + 1) & mask; m->index[i] != 0; i = (i + 1) & mask) {
+        size_t home = m->entries.array[m->index[i] - 1].hash & mask;
+        if (((i - home) & mask) >= ((i - slot) & mask)) {
+            m->index[slot] = m->index[i];
+            slot = i;
+        }
+    }
+    m->index[slot] = 0;
+
+    if (pos == m->entries.size - 1) {
+        m->entries.size--;
+    } else {
+        m->entries.array[pos].hash = CGS_DENSE_MAP_DEAD;
+    }
+    m->size--;
+    if (m->entries.size - m->size > m->size) {
+        CGS_DENSE_MAP_INTERNAL(rehash)(m, m->capacity);
+    }
+    return res;
+}
+
+/**
+ * @brief Drops all tombstones from the entry array, so that the live entries are contiguous.
+ * This is done automatically once the tombstones outnumber the live entries.
+ * @param m The map to use.
+ */
+static inline void CGS_DENSE_MAP(compact)(cgs_map_name *m) {
+    if (m->entries.size != m->size) {
+        CGS_DENSE_MAP_INTERNAL(rehash)(m, m->capacity);
+    }
+}
+
+/**
+ * @brief Removes all entries from the map.
+ * The capacity of the index table and the entry array is kept.
+ * @param m The map to use.
+ */
+static inline void CGS_DENSE_MAP(clear)(cgs_map_name *m) {
+    memset(m->index, 0, m->capacity * sizeof(uint32_t));
+    CGS_DENSE_MAP_INTERNAL(vec_clear)(&m->entries);
+    m->size = 0;
+}
+
+/**
+ * @brief Frees the data structures of a map initialized with init(), but not the map itself.
+ * The map must be initialized again before it is used.
+ * @param m The map to destroy.
+ */
+static inline void CGS_DENSE_MAP(destroy)(cgs_map_name *m) {
+    cgs_map_free(m->alloc_ctx, m->index, m->capacity * sizeof(uint32_t));
+    CGS_DENSE_MAP_INTERNAL(vec_destroy)(&m->entries);
+}
+
+/**
+ * @brief Frees the map and all of its data structures.
+ * @param m The map to free.
+ */
+static inline void CGS_DENSE_MAP(free)(cgs_map_name *m) {
+    CGS_DENSE_MAP(destroy)(m);
+    cgs_map_free(m->alloc_ctx, m, sizeof(cgs_map_name));
+}
+
+#undef cgs_map_key
+#undef cgs_map_value
+#undef cgs_map_name
+#undef cgs_map_default_value
+#undef cgs_map_initial_capacity
+#undef cgs_map_load_factor
+#undef cgs_map_malloc
+#undef cgs_map_realloc
+#undef cgs_map_free
+#endif /* include guard */
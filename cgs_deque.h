@@ -0,0 +1,264 @@
+/**
+ * @file cgs_deque.h
+ * @brief A variable-length double-ended queue, backed with a circular array.
+ *
+ * Elements can be pushed and popped at both ends in amortized O(1), and accessed by index in O(1).
+ * The elements are stored in at most two contiguous segments, which can be visited with segment().
+ *
+ * Define the following macros before including the header.
+ * - cgs_deque_name: The name of the generated deque type. (e.g. `my_deque`)
+ * - cgs_deque_type: The type of the elements. (e.g. `int`, `char *`)
+ *
+ * The following macros are optional, and replace the global allocator hooks of cgs_common.h for this deque.
+ * - cgs_deque_malloc(ctx, size): Allocates memory.
+ * - cgs_deque_realloc(ctx, ptr, old_size, size): Resizes memory allocated with cgs_deque_malloc.
+ * - cgs_deque_free(ctx, ptr, size): Frees memory allocated with cgs_deque_malloc.
+ *
+ * After the header is included, define the macro `cgs_<cgs_deque_name>` to 1.
+ * This is to prevent clashes from multiple includes.
+ *
+ * For example, the following code generates the type `ddeque` as a deque of doubles.
+ * ```
+ * #define cgs_deque_type double
+ * #define cgs_deque_name ddeque
+ * #include "cgs_deque.h"
+ * #define cgs_ddeque 1
+ * ```
+ */
+
+#include "cgs_common.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+/* Common macros (include only once) */
+#ifndef CGS_DEQUE_H
+#define CGS_DEQUE_H
+
+#define CGS_DEQUE(name) CGS_CAT(cgs_deque_name, name)
+
+#endif
+
+/* semi include guard */
+#if !CGS_CAT(cgs, cgs_deque_name)
+
+typedef cgs_deque_type CGS_DEQUE(type);
+
+/* Must be a power of two. */
+#define CGS_DEQUE_INIT_CAPACITY 8
+
+#ifndef cgs_deque_malloc
+#define cgs_deque_malloc CGS_MALLOC
+#endif
+#ifndef cgs_deque_realloc
+#define cgs_deque_realloc CGS_REALLOC
+#endif
+#ifndef cgs_deque_free
+#define cgs_deque_free CGS_FREE
+#endif
+
+/*
+ * The elements are stored from `head`, wrapping around at the end of the array.
+ * The capacity is always a power of two, so that indices can be wrapped with a mask.
+ */
+typedef struct cgs_deque_name {
+    cgs_deque_type *array;
+    size_t head, size, capacity;
+    void *alloc_ctx;
+} cgs_deque_name;
+
+/**
+ * @brief Allocate and initialize a new deque that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized deque.
+ */
+static inline cgs_deque_name *CGS_DEQUE(new_with_ctx)(void *ctx) {
+    cgs_deque_name *d = cgs_deque_malloc(ctx, sizeof(cgs_deque_name));
+    d->head = 0;
+    d->size = 0;
+    d->capacity = CGS_DEQUE_INIT_CAPACITY;
+    d->array = cgs_deque_malloc(ctx, sizeof(cgs_deque_type) * CGS_DEQUE_INIT_CAPACITY);
+    d->alloc_ctx = ctx;
+    return d;
+}
+
+/**
+ * @brief Allocate and initialize a new deque.
+ * @return A newly allocated and initialized deque.
+ */
+static inline cgs_deque_name *CGS_DEQUE(new)() {
+    return CGS_DEQUE(new_with_ctx)(NULL);
+}
+
+/**
+ * @brief Get a pointer to the element at a given index in the deque.
+ * @param d The deque to query.
+ * @param index The index to the desired element.
+ * @return A pointer to the element at the given index.
+ */
+static inline cgs_deque_type *CGS_DEQUE(ptr)(cgs_deque_name *d, size_t index) {
+    assert(index < d->size);
+    return &d->array[(d->head + index) & (d->capacity - 1)];
+}
+
+/**
+ * @brief Get the element at a given index in the deque.
+ * @param d The deque to query.
+ * @param index The index to the desired element.
+ * @return The element at the given index.
+ */
+static inline cgs_deque_type CGS_DEQUE(at)(cgs_deque_name *d, size_t index) {
+    return *CGS_DEQUE(ptr)(d, index);
+}
+
+/**
+ * @brief Set the element at a given index in the deque.
+ * @param d The deque to query.
+ * @param index The index to the desired element.
+ * @param e The element to set to.
+ */
+static inline void CGS_DEQUE(set)(cgs_deque_name *d, size_t index, cgs_deque_type e) {
+    *CGS_DEQUE(ptr)(d, index) = e;
+}
+
+/**
+ * @brief Get the first element of the deque.
+ * @param d The deque to query.
+ * @return The first element.
+ */
+static inline cgs_deque_type CGS_DEQUE(front)(cgs_deque_name *d) {
+    return CGS_DEQUE(at)(d, 0);
+}
+
+/**
+ * @brief Get the last element of the deque.
+ * @param d The deque to query.
+ * @return The last element.
+ */
+static inline cgs_deque_type CGS_DEQUE(back)(cgs_deque_name *d) {
+    return CGS_DEQUE(at)(d, d->size - 1);
+}
+
+/**
+ * @brief Check whether the deque is empty.
+ * @param d The deque to query.
+ * @return Whether the deque is empty.
+ */
+static inline bool CGS_DEQUE(empty)(cgs_deque_name *d) {
+    return d->size == 0;
+}
+
+/**
+ * @brief Get the contiguous run of elements that starts at a given index.
+ * Calling this with index 0, then with the index right after the returned run, visits the whole deque
+ * in at most two runs.
+ * @param d The deque to query.
+ * @param index The index of the first element of the run.
+ * @param n Set to the number of elements in the run.
+ * @return A pointer to the first element of the run.
+ */
+static inline cgs_deque_type *CGS_DEQUE(segment)(cgs_deque_name *d, size_t index, size_t *n) {
+    size_t start = (d->head + index) & (d->capacity - 1);
+    size_t remaining = d->size - index;
+    assert(index < d->size);
+    *n = d->capacity - start < remaining ? d->capacity - start : remaining;
+    return &d->array[start];
+}
+
+/**
+ * @brief Reserve capacity in the deque.
+ * Ensures that the deque's capacity is at least as large as the given size.
+ * @param d The deque to use.
+ * @param s The desired capacity.
+ */
+static inline void CGS_DEQUE(reserve)(cgs_deque_name *d, size_t s) {
+    if (s > d->capacity) {
+        size_t capacity = d->capacity * 2;
+        while (capacity < s) {
+            capacity *= 2;
+        }
+        d->array = cgs_deque_realloc(d->alloc_ctx, d->array, sizeof(cgs_deque_type) * d->capacity,
+                                     sizeof(cgs_deque_type) * capacity);
+        if (d->head + d->size > d->capacity) {
+            /* the elements wrapped around: move the part before the old end to the new end */
+            size_t count = d->capacity - d->head;
+            memcpy(&d->array[capacity - count], &d->array[d->head], count * sizeof(cgs_deque_type));
+            d->head = capacity - count;
+        }
+        d->capacity = capacity;
+    }
+}
+
+/**
+ * @brief Push an element to the end of the deque.
+ * @param d The deque to use.
+ * @param e The element to push.
+ */
+static inline void CGS_DEQUE(push_back)(cgs_deque_name *d, cgs_deque_type e) {
+    CGS_DEQUE(reserve)(d, d->size + 1);
+    d->array[(d->head + d->size) & (d->capacity - 1)] = e;
+    d->size++;
+}
+
+/**
+ * @brief Push an element to the front of the deque.
+ * @param d The deque to use.
+ * @param e The element to push.
+ */
+static inline void CGS_DEQUE(push_front)(cgs_deque_name *d, cgs_deque_type e) {
+    CGS_DEQUE(reserve)(d, d->size + 1);
+    d->head = (d->head - 1) & (d->capacity - 1);
+    d->array[d->head] = e;
+    d->size++;
+}
+
+/**
+ * @brief Pop an element from the end of the deque and return it.
+ * @param d The deque to use.
+ * @return The element that was popped.
+ */
+static inline cgs_deque_type CGS_DEQUE(pop_back)(cgs_deque_name *d) {
+    assert(d->size > 0);
+    d->size--;
+    return d->array[(d->head + d->size) & (d->capacity - 1)];
+}
+
+/**
+ * @brief Pop an element from the front of the deque and return it.
+ * @param d The deque to use.
+ * @return The element that was popped.
+ */
+static inline cgs_deque_type CGS_DEQUE(pop_front)(cgs_deque_name *d) {
+    cgs_deque_type res;
+    assert(d->size > 0);
+    res = d->array[d->head];
+    d->head = (d->head + 1) & (d->capacity - 1);
+    d->size--;
+    return res;
+}
+
+/**
+ * @brief Remove all elements from the deque.
+ * @param d The deque to use.
+ */
+static inline void CGS_DEQUE(clear)(cgs_deque_name *d) {
+    d->head = 0;
+    d->size = 0;
+}
+
+/**
+ * @brief Frees the deque and all of its data structures.
+ * @param d The deque to free.
+ */
+static inline void CGS_DEQUE(free)(cgs_deque_name *d) {
+    cgs_deque_free(d->alloc_ctx, d->array, sizeof(cgs_deque_type) * d->capacity);
+    cgs_deque_free(d->alloc_ctx, d, sizeof(cgs_deque_name));
+}
+
+#undef cgs_deque_type
+#undef cgs_deque_name
+#undef cgs_deque_malloc
+#undef cgs_deque_realloc
+#undef cgs_deque_free
+#endif /* include guard */
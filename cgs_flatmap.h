@@ -0,0 +1,365 @@
+/**
+ * @file cgs_flatmap.h
+ * @brief An unordered map, implemented with an open-addressing hash table.
+ *
+ * Unlike cgs_map.h, keys and values are stored inline in a single contiguous table, so no allocation is
+ * performed per entry. Each slot has a one-byte control value holding 7 bits of its hash, and lookups scan
+ * the control bytes in groups of 16 (with SSE2 if available), only touching the slots that are likely to match.
+ *
+ * The macros are the same as in cgs_map.h.
+ * - cgs_map_name: Required. The name of the generated map type. (e.g. `my_map`)
+ * - cgs_map_key: Required. The type of the key. (e.g. `int`, `char *`)
+ * - cgs_map_value: Required. The type of the value. (e.g. `int`, `char *`)
+ * - cgs_map_initial_capacity: Optional. The initial capacity of the map. (Default: 16)
+ * - cgs_map_default_value: Optional. The default value returned when the element is not found. (Default: 0)
+ * - cgs_map_load_factor: Optional. The maximum load factor as an integer percentage. (Default: 87)
+ * - cgs_map_malloc(ctx, size), cgs_map_free(ctx, ptr, size): Optional. Replace the global allocator hooks
+ *   of cgs_common.h for this map.
+ *
+ * The hashing function is chosen with the `cgs_map_default_hash*` macros, or defined manually,
+ * exactly as in cgs_map.h.
+ *
+ * After the header is included, define the macro `cgs_<cgs_map_name>` to 1.
+ * This is to prevent clashes from multiple includes.
+ *
+ * For example, the following code generates the type `llfmap` with `int64_t`->`int64_t` key-value types.
+ *
+ * ```
+ * #define cgs_map_key int64_t
+ * #define cgs_map_value int64_t
+ * #define cgs_map_default_hash
+ * #define cgs_map_name llfmap
+ * #include "cgs_flatmap.h"
+ * #define cgs_llfmap 1
+ * ```
+ */
+
+#include "cgs_common.h"
+#include "cgs_hash.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CGS_FLATMAP_SSE2 1
+#endif
+
+/* Common functions (include only once) */
+#ifndef CGS_FLATMAP_H
+#define CGS_FLATMAP_H
+
+/** The number of control bytes probed at once. */
+#define CGS_FLATMAP_GROUP_WIDTH 16
+/** Control byte of a slot that was never used. */
+#define CGS_FLATMAP_EMPTY ((int8_t) -128)
+/** Control byte of a slot whose entry was erased. */
+#define CGS_FLATMAP_DELETED ((int8_t) -2)
+
+/**
+ * @brief Finds the slots of a group with the given control byte.
+ * @param ctrl The control bytes of the group.
+ * @param c The control byte to match.
+ * @return A bitmask with the n-th bit set if the n-th slot matches.
+ */
+static inline uint32_t cgs_flatmap_match(const int8_t *ctrl, int8_t c) {
+#ifdef CGS_FLATMAP_SSE2
+    __m128i group = _mm_loadu_si128((const __m128i *) ctrl);
+    return (uint32_t) _mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(c)));
+#else
+    uint32_t res = 0;
+    for (int i = 0; i < CGS_FLATMAP_GROUP_WIDTH; i++) {
+        res |= (uint32_t) (ctrl[i] == c) << i;
+    }
+    return res;
+#endif
+}
+
+/**
+ * @brief Finds the slots of a group that are empty or deleted.
+ * @param ctrl The control bytes of the group.
+ * @return A bitmask with the n-th bit set if the n-th slot is free.
+ */
+static inline uint32_t cgs_flatmap_match_free(const int8_t *ctrl) {
+#ifdef CGS_FLATMAP_SSE2
+    /* only the free control bytes have their sign bit set */
+    return (uint32_t) _mm_movemask_epi8(_mm_loadu_si128((const __m128i *) ctrl));
+#else
+    uint32_t res = 0;
+    for (int i = 0; i < CGS_FLATMAP_GROUP_WIDTH; i++) {
+        res |= (uint32_t) (ctrl[i] < 0) << i;
+    }
+    return res;
+#endif
+}
+
+#define CGS_FLATMAP(name) CGS_CAT(cgs_map_name, name)
+#define CGS_FLATMAP_INTERNAL(name) CGS_CAT_INTERNAL(cgs_map_name, name)
+
+#endif
+
+/* semi include guard */
+#if !CGS_CAT(cgs, cgs_map_name)
+
+typedef cgs_map_key CGS_FLATMAP(key);
+typedef cgs_map_value CGS_FLATMAP(value);
+
+#ifndef cgs_map_initial_capacity
+#define cgs_map_initial_capacity 16
+#endif
+
+#ifndef cgs_map_default_value
+#define cgs_map_default_value 0
+#endif
+
+#ifndef cgs_map_load_factor
+#define cgs_map_load_factor 87
+#endif
+
+#ifndef cgs_map_malloc
+#define cgs_map_malloc CGS_MALLOC
+#endif
+#ifndef cgs_map_free
+#define cgs_map_free CGS_FREE
+#endif
+
+#define cgs_hash_key cgs_map_key
+#define cgs_hash_name CGS_FLATMAP(hash)
+#include "cgs_hash.h"
+
+/** A key-value pair stored inline in the table. */
+typedef struct CGS_FLATMAP(slot) {
+    cgs_map_key key;
+    cgs_map_value value;
+} CGS_FLATMAP(slot);
+
+typedef struct {
+    size_t size;
+    size_t capacity; /* power of two, and a multiple of CGS_FLATMAP_GROUP_WIDTH */
+    size_t growth_left; /* the number of empty slots that may be filled before rehashing */
+    int8_t *ctrl; /* one control byte per slot, in the same allocation as the slots */
+    CGS_FLATMAP(slot) *slots;
+    void *alloc_ctx;
+} cgs_map_name;
+
+/** @private Returns the number of entries a table with the given capacity may hold. */
+static inline size_t CGS_FLATMAP_INTERNAL(max_load)(size_t capacity) {
+    size_t res = capacity * cgs_map_load_factor / 100;
+    return res < capacity ? res : capacity - 1; /* keep at least one empty slot to terminate probes */
+}
+
+/** @private Returns the size of the allocation that holds a table with the given capacity. */
+static inline size_t CGS_FLATMAP_INTERNAL(table_size)(size_t capacity) {
+    return capacity + capacity * sizeof(CGS_FLATMAP(slot));
+}
+
+/** @private Allocates an empty table with the given capacity. */
+static inline void CGS_FLATMAP_INTERNAL(alloc_table)(cgs_map_name *m, size_t capacity) {
+    /* the control bytes come first, which keeps the slots aligned since the capacity is a multiple of 16 */
+    m->ctrl = cgs_map_malloc(m->alloc_ctx, CGS_FLATMAP_INTERNAL(table_size)(capacity));
+    m->slots = (CGS_FLATMAP(slot) *) (m->ctrl + capacity);
+    memset(m->ctrl, CGS_FLATMAP_EMPTY, capacity);
+    m->capacity = capacity;
+    m->growth_left = CGS_FLATMAP_INTERNAL(max_load)(capacity);
+}
+
+/**
+ * @brief Initializes a map in place, e.g. one embedded in another struct or on the stack.
+ * @param m The map to initialize.
+ * @param ctx The context pointer passed to the allocator hooks.
+ */
+static inline void CGS_FLATMAP(init)(cgs_map_name *m, void *ctx) {
+    m->alloc_ctx = ctx;
+    size_t capacity = CGS_FLATMAP_GROUP_WIDTH;
+    while (capacity < (cgs_map_initial_capacity)) {
+        capacity *= 2;
+    }
+    CGS_FLATMAP_INTERNAL(alloc_table)(m, capacity);
+    m->size = 0;
+}
+
+/**
+ * @brief Allocates and initializes a new map that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized map.
+ */
+static inline cgs_map_name *CGS_FLATMAP(new_with_ctx)(void *ctx) {
+    cgs_map_name *m = cgs_map_malloc(ctx, sizeof(cgs_map_name));
+    CGS_FLATMAP(init)(m, ctx);
+    return m;
+}
+
+/**
+ * @brief Allocates and initializes a new map.
+ * @return A newly allocated and initialized map.
+ */
+static inline cgs_map_name *CGS_FLATMAP(new)() {
+    return CGS_FLATMAP(new_with_ctx)(NULL);
+}
+
+/** @private Finds the slot index of the given key, or returns -1 if it does not exist. */
+static inline size_t CGS_FLATMAP_INTERNAL(find_slot)(cgs_map_name *m, uint32_t hash, cgs_map_key key) {
+    size_t group_mask = m->capacity / CGS_FLATMAP_GROUP_WIDTH - 1;
+    size_t group = (hash >> 7) & group_mask;
+    int8_t h2 = (int8_t) (hash & 0x7f);
+    for (size_t step = 1;; step++) {
+        const int8_t *ctrl = m->ctrl + group * CGS_FLATMAP_GROUP_WIDTH;
+        uint32_t matches = cgs_flatmap_match(ctrl, h2);
+        while (matches != 0) {
+            size_t index = group * CGS_FLATMAP_GROUP_WIDTH + cgs_ctz32(matches);
+            if (m->slots[index].key == key) {
+                return index;
+            }
+            matches &= matches - 1;
+        }
+        if (cgs_flatmap_match(ctrl, CGS_FLATMAP_EMPTY) != 0) {
+            return -1;
+        }
+        group = (group + step) & group_mask; /* triangular probing visits every group */
+    }
+}
+
+/** @private Finds the first empty or deleted slot in the probe sequence of the hash. */
+static inline size_t CGS_FLATMAP_INTERNAL(find_free)(cgs_map_name *m, uint32_t hash) {
+    size_t group_mask = m->capacity / CGS_FLATMAP_GROUP_WIDTH - 1;
+    size_t group = (hash >> 7) & group_mask;
+    for (size_t step = 1;; step++) {
+        uint32_t free_slots = cgs_flatmap_match_free(m->ctrl + group * CGS_FLATMAP_GROUP_WIDTH);
+        if (free_slots != 0) {
+            return group * CGS_FLATMAP_GROUP_WIDTH + cgs_ctz32(free_slots);
+        }
+        group = (group + step) & group_mask;
+    }
+}
+
+/** @private Moves all entries to a new table with the given capacity. Also drops the deleted slots. */
+static inline void CGS_FLATMAP_INTERNAL(rehash)(cgs_map_name *m, size_t capacity) {
+    int8_t *old_ctrl = m->ctrl;
+    CGS_FLATMAP(slot) *old_slots = m->slots;
+    size_t old_capacity = m->capacity;
+
+    CGS_FLATMAP_INTERNAL(alloc_table)(m, capacity);
+    for (size_t i = 0; i < old_capacity; i++) {
+        if (old_ctrl[i] >= 0) {
+            uint32_t hash = CGS_FLATMAP(hash)(old_slots[i].key);
+            size_t index = CGS_FLATMAP_INTERNAL(find_free)(m, hash);
+            m->ctrl[index] = (int8_t) (hash & 0x7f);
+            m->slots[index] = old_slots[i];
+        }
+    }
+    m->growth_left -= m->size;
+    cgs_map_free(m->alloc_ctx, old_ctrl, CGS_FLATMAP_INTERNAL(table_size)(old_capacity));
+}
+
+/**
+ * @brief Inserts a key-value pair to the map.
+ * If the key already exists, the existing value is modified.
+ * @param m The map to use.
+ * @param key The key to insert.
+ * @param value The value to insert.
+ */
+static inline void CGS_FLATMAP(insert)(cgs_map_name *m, cgs_map_key key, cgs_map_value value) {
+    uint32_t hash = CGS_FLATMAP(hash)(key);
+    size_t index = CGS_FLATMAP_INTERNAL(find_slot)(m, hash, key);
+    if (index != (size_t) -1) {
+        m->slots[index].value = value;
+        return;
+    }
+
+    index = CGS_FLATMAP_INTERNAL(find_free)(m, hash);
+    if (m->ctrl[index] == CGS_FLATMAP_EMPTY && m->growth_left == 0) {
+        /* if most of the used slots are tombstones, rehashing in place is enough */
+        size_t max_load = CGS_FLATMAP_INTERNAL(max_load)(m->capacity);
+        CGS_FLATMAP_INTERNAL(rehash)(m, m->size * 2 < max_load ? m->capacity : m->capacity * 2);
+        index = CGS_FLATMAP_INTERNAL(find_free)(m, hash);
+    }
+
+    if (m->ctrl[index] == CGS_FLATMAP_EMPTY) {
+        m->growth_left--;
+    }
+    m->ctrl[index] = (int8_t) (hash & 0x7f);
+    m->slots[index].key = key;
+    m->slots[index].value = value;
+    m->size++;
+}
+
+/**
+ * @brief Finds the value associated with the given key.
+ * If the key is not found, returns the default value defined with `cgs_map_default_value`.
+ * @param m The map to use.
+ * @param key The key to find.
+ * @return The value associated with the given key, or the default value.
+ */
+static inline cgs_map_value CGS_FLATMAP(find)(cgs_map_name *m, cgs_map_key key) {
+    size_t index = CGS_FLATMAP_INTERNAL(find_slot)(m, CGS_FLATMAP(hash)(key), key);
+    return index == (size_t) -1 ? (cgs_map_default_value) : m->slots[index].value;
+}
+
+/**
+ * @brief Erases the entry with the given key and returns the value it was associated with.
+ * If the key is not found, returns the default value defined with `cgs_map_default_value`.
+ * @param m The map to use.
+ * @param key The key to erase.
+ * @return The value previously associated with the given key, or the default value.
+ */
+static inline cgs_map_value CGS_FLATMAP(erase)(cgs_map_name *m, cgs_map_key key) {
+    size_t index = CGS_FLATMAP_INTERNAL(find_slot)(m, CGS_FLATMAP(hash)(key), key);
+    if (index == (size_t) -1) {
+        return cgs_map_default_value;
+    }
+
+    /*
+     * Probes stop at the first group with an empty slot, so if this group already has one,
+     * no probe sequence can pass through it and the slot may become empty again.
+     */
+    const int8_t *group = m->ctrl + index / CGS_FLATMAP_GROUP_WIDTH * CGS_FLATMAP_GROUP_WIDTH;
+    if (cgs_flatmap_match(group, CGS_FLATMAP_EMPTY) != 0) {
+        m->ctrl[index] = CGS_FLATMAP_EMPTY;
+        m->growth_left++;
+    } else {
+        m->ctrl[index] = CGS_FLATMAP_DELETED;
+    }
+    m->size--;
+    return m->slots[index].value;
+}
+
+/**
+ * @brief Removes all entries from the map.
+ * The capacity of the table is kept.
+ * @param m The map to use.
+ */
+static inline void CGS_FLATMAP(clear)(cgs_map_name *m) {
+    memset(m->ctrl, CGS_FLATMAP_EMPTY, m->capacity);
+    m->growth_left = CGS_FLATMAP_INTERNAL(max_load)(m->capacity);
+    m->size = 0;
+}
+
+/**
+ * @brief Frees the data structures of a map initialized with init(), but not the map itself.
+ * The map must be initialized again before it is used.
+ * @param m The map to destroy.
+ */
+static inline void CGS_FLATMAP(destroy)(cgs_map_name *m) {
+    cgs_map_free(m->alloc_ctx, m->ctrl, CGS_FLATMAP_INTERNAL(table_size)(m->capacity));
+}
+
+/**
+ * @brief Frees the map and all of its data structures.
+ * @param m The map to free.
+ */
+static inline void CGS_FLATMAP(free)(cgs_map_name *m) {
+    CGS_FLATMAP(destroy)(m);
+    cgs_map_free(m->alloc_ctx, m, sizeof(cgs_map_name));
+}
+
+#undef cgs_map_key
+#undef cgs_map_value
+#undef cgs_map_name
+#undef cgs_map_default_value
+#undef cgs_map_initial_capacity
+#undef cgs_map_load_factor
+#undef cgs_map_malloc
+#undef cgs_map_free
+#endif /* include guard */
@@ -0,0 +1,354 @@
+/**
+ * @file cgs_hash.h
+ * @brief Hash functions shared by the map headers.
+ *
+ * This header is included by the map headers, so it usually does not need to be included directly.
+ *
+ * When the macro `cgs_hash_name` is defined, a hash function with that name is generated for the key type
+ * `cgs_hash_key`, according to which of the `cgs_map_default_hash*` macros is defined.
+ * See cgs_map.h for the list of supported hashing modes.
+ */
+
+#include "cgs_common.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+/* Common functions (include only once) */
+#ifndef CGS_HASH_H
+#define CGS_HASH_H
+
+/**
+ * @brief Hash a single 32-bit integer.
+ * The algorithm from https://github.com/skeeto/hash-prospector is used.
+ * @param x The integer to hash.
+ * @return The hash result.
+ */
+static inline uint32_t cgs_map_hash_single(uint32_t x) {
+    // https://github.com/skeeto/hash-prospector
+    x ^= x >> 15;
+    x *= 0xd168aaad;
+    x ^= x >> 15;
+    x *= 0xaf723597;
+    x ^= x >> 15;
+    return x;
+}
+
+/**
+ * @brief Hash the given data.
+ * @param ptr The pointer to the data.
+ * @param size The size of the data.
+ * @return The hash result.
+ */
+static inline uint32_t cgs_map_hash(const void *ptr, size_t size) {
+    uint32_t res = 1;
+    while (size & 3) { // size % 4
+        res <<= 8;
+        res |= ((char *) ptr)[size - 1];
+        size--;
+    }
+    res = cgs_map_hash_single(res);
+    for (size_t i = 0; i < size / 4; i++) {
+        res ^= ((uint32_t *) ptr)[i];
+        res = cgs_map_hash_single(res);
+    }
+    return res;
+}
+
+/**
+ * @brief Hash the given string.
+ * @param ptr The string to hash.
+ * @return The hash result.
+ */
+static inline uint32_t cgs_map_hash_str(const char *ptr) {
+    uint32_t res = 1;
+    while(ptr[0] != 0) {
+        uint32_t next = 1;
+        for (int i = 0; i < 4 && ptr[0] != 0; i++) { // size % 4
+            next <<= 8;
+            next |= ptr[0];
+            ptr++;
+        }
+        res ^= next;
+        res = cgs_map_hash_single(res);
+    }
+    return res;
+}
+
+/**
+ * @brief Multiply two 64-bit integers, and fold the 128-bit result into 64 bits.
+ * @param a The first factor.
+ * @param b The second factor.
+ * @return The folded product.
+ */
+static inline uint64_t cgs_map_hash_mum(uint64_t a, uint64_t b) {
+#ifdef __SIZEOF_INT128__
+    __uint128_t r = (__uint128_t) a * b;
+    return (uint64_t) r ^ (uint64_t) (r >> 64);
+#else
+    uint64_t ha = a >> 32, hb = b >> 32, la = (uint32_t) a, lb = (uint32_t) b;
+    uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb, t = rl + (rm0 << 32), c = t < rl;
+    uint64_t lo = t + (rm1 << 32);
+    c += lo < t;
+    uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+    return lo ^ hi;
+#endif
+}
+
+/** @private Reads an unaligned 64-bit word. */
+static inline uint64_t cgs_map_hash_read64(const uint8_t *p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/** @private Reads an unaligned 32-bit word. */
+static inline uint64_t cgs_map_hash_read32(const uint8_t *p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+/**
+ * @brief Hash the given data into 64 bits, consuming up to 48 bytes per step.
+ * The algorithm is based on wyhash (https://github.com/wangyi-fudan/wyhash), which is in the public domain.
+ * Much faster than cgs_map_hash() for anything longer than a few bytes.
+ * @param ptr The pointer to the data.
+ * @param size The size of the data.
+ * @return The hash result.
+ */
+static inline uint64_t cgs_map_hash64(const void *ptr, size_t size) {
+    static const uint64_t s[4] = {0xa0761d6478bd642full, 0xe7037ed1a0b428dbull,
+                                  0x8ebc6af09c88c6e3ull, 0x589965cc75374cc3ull};
+    const uint8_t *p = (const uint8_t *) ptr;
+    uint64_t seed = s[0], a, b;
+    if (size <= 16) {
+        if (size >= 4) {
+            size_t mid = (size >> 3) << 2;
+            a = (cgs_map_hash_read32(p) << 32) | cgs_map_hash_read32(p + mid);
+            b = (cgs_map_hash_read32(p + size - 4) << 32) | cgs_map_hash_read32(p + size - 4 - mid);
+        } else if (size > 0) {
+            a = ((uint64_t) p[0] << 16) | ((uint64_t) p[size >> 1] << 8) | p[size - 1];
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = size;
+        if (i > 48) {
+            /* three independent lanes keep the multipliers busy */
+            uint64_t seed1 = seed, seed2 = seed;
+            do {
+                seed = cgs_map_hash_mum(cgs_map_hash_read64(p) ^ s[1], cgs_map_hash_read64(p + 8) ^ seed);
+                seed1 = cgs_map_hash_mum(cgs_map_hash_read64(p + 16) ^ s[2], cgs_map_hash_read64(p + 24) ^ seed1);
+                seed2 = cgs_map_hash_mum(cgs_map_hash_read64(p + 32) ^ s[3], cgs_map_hash_read64(p + 40) ^ seed2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= seed1 ^ seed2;
+        }
+        while (i > 16) {
+            seed = cgs_map_hash_mum(cgs_map_hash_read64(p) ^ s[1], cgs_map_hash_read64(p + 8) ^ seed);
+            p += 16;
+            i -= 16;
+        }
+        a = cgs_map_hash_read64(p + i - 16);
+        b = cgs_map_hash_read64(p + i - 8);
+    }
+    return cgs_map_hash_mum(s[1] ^ size, cgs_map_hash_mum(a ^ s[1], b ^ seed));
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+/** @private A word type that may alias any object. */
+typedef uint64_t __attribute__((__may_alias__)) cgs_map_hash_word;
+/* Aligned words never cross a page boundary, so reading past the terminator is safe, but sanitizers can't tell. */
+#define CGS_HASH_NO_SANITIZE __attribute__((no_sanitize_address))
+#else
+#define CGS_HASH_NO_SANITIZE
+#endif
+
+/**
+ * @brief Find the length of a string, scanning 8 bytes at a time.
+ * @param str The null-terminated string.
+ * @return The length of the string.
+ */
+CGS_HASH_NO_SANITIZE static inline size_t cgs_map_hash_strlen(const char *str) {
+    const char *p = str;
+#if defined(__GNUC__) || defined(__clang__)
+    while ((uintptr_t) p & 7) {
+        if (*p == 0) {
+            return p - str;
+        }
+        p++;
+    }
+    for (;;) {
+        uint64_t w = *(const cgs_map_hash_word *) p;
+        /* nonzero iff one of the bytes is zero */
+        if ((w - 0x0101010101010101ull) & ~w & 0x8080808080808080ull) {
+            break;
+        }
+        p += 8;
+    }
+#endif
+    while (*p != 0) {
+        p++;
+    }
+    return p - str;
+}
+
+/**
+ * @brief Hash the given string into 64 bits.
+ * Equivalent to cgs_map_hash64() over the characters of the string.
+ * @param str The string to hash.
+ * @return The hash result.
+ */
+static inline uint64_t cgs_map_hash_str64(const char *str) {
+    return cgs_map_hash64(str, cgs_map_hash_strlen(str));
+}
+
+/**
+ * @brief Hash an integer with a 64-bit mixer.
+ * The algorithm from https://github.com/skeeto/hash-prospector is used.
+ * @param x The integer to hash.
+ * @return The hash result.
+ */
+static inline uint32_t cgs_map_hash_int_mix(uint64_t x) {
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ull;
+    x ^= x >> 32;
+    x *= 0xd6e8feb86659fd93ull;
+    x ^= x >> 32;
+    return (uint32_t) x;
+}
+
+/**
+ * @brief Hash an integer with Fibonacci hashing, a single multiplication by 2^64 / phi.
+ * Cheaper than cgs_map_hash_int_mix(), but keys that differ only in their high bits may collide.
+ * @param x The integer to hash.
+ * @return The hash result.
+ */
+static inline uint32_t cgs_map_hash_int_fibonacci(uint64_t x) {
+    return (uint32_t) ((x * 0x9e3779b97f4a7c15ull) >> 32);
+}
+
+/**
+ * @brief Use an integer as its own hash, folded into 32 bits.
+ * Only suitable for keys that are already uniformly random, such as random ids.
+ * @param x The integer to hash.
+ * @return The hash result.
+ */
+static inline uint32_t cgs_map_hash_int_identity(uint64_t x) {
+    return (uint32_t) (x ^ (x >> 32));
+}
+
+/**
+ * @brief Load an integer key of 1, 2, 4 or 8 bytes into a 64-bit integer.
+ * Calls with a constant size compile into a single load.
+ * @param ptr The pointer to the key.
+ * @param size The size of the key.
+ * @return The zero-extended key.
+ */
+static inline uint64_t cgs_map_hash_load_int(const void *ptr, size_t size) {
+    switch (size) {
+        case 1: {
+            uint8_t v;
+            memcpy(&v, ptr, 1);
+            return v;
+        }
+        case 2: {
+            uint16_t v;
+            memcpy(&v, ptr, 2);
+            return v;
+        }
+        case 4: {
+            uint32_t v;
+            memcpy(&v, ptr, 4);
+            return v;
+        }
+        default: {
+            uint64_t v;
+            memcpy(&v, ptr, 8);
+            return v;
+        }
+    }
+}
+
+/** @private Whether keys of the given size are hashed as integers. */
+#define CGS_HASH_IS_INT_SIZE(size) ((size) == 1 || (size) == 2 || (size) == 4 || (size) == 8)
+
+/**
+ * @brief Fold a 64-bit hash into 32 bits.
+ * @param h The hash to fold.
+ * @return The folded hash.
+ */
+static inline uint32_t cgs_map_hash_fold(uint64_t h) {
+    return (uint32_t) (h ^ (h >> 32));
+}
+
+#endif
+
+/* Hash function generation */
+#ifdef cgs_hash_name
+
+#if defined(cgs_map_int_hash_identity)
+#define CGS_HASH_INT cgs_map_hash_int_identity
+#elif defined(cgs_map_int_hash_fibonacci)
+#define CGS_HASH_INT cgs_map_hash_int_fibonacci
+#else
+#define CGS_HASH_INT cgs_map_hash_int_mix
+#endif
+
+#ifdef cgs_map_default_hash_str
+static inline uint32_t cgs_hash_name(cgs_hash_key k) {
+    return cgs_map_hash_str(k);
+}
+#undef cgs_map_default_hash_str
+#endif
+
+#ifdef cgs_map_default_hash_ptr
+static inline uint32_t cgs_hash_name(cgs_hash_key k) {
+    return cgs_map_hash(k, sizeof(*k));
+}
+#undef cgs_map_default_hash_ptr
+#endif
+
+#ifdef cgs_map_default_hash
+static inline uint32_t cgs_hash_name(cgs_hash_key k) {
+    if (CGS_HASH_IS_INT_SIZE(sizeof(cgs_hash_key))) {
+        return CGS_HASH_INT(cgs_map_hash_load_int(&k, sizeof(cgs_hash_key)));
+    }
+    return cgs_map_hash(&k, sizeof(cgs_hash_key));
+}
+#undef cgs_map_default_hash
+#endif
+
+#ifdef cgs_map_default_hash_fast
+static inline uint32_t cgs_hash_name(cgs_hash_key k) {
+    if (CGS_HASH_IS_INT_SIZE(sizeof(cgs_hash_key))) {
+        return CGS_HASH_INT(cgs_map_hash_load_int(&k, sizeof(cgs_hash_key)));
+    }
+    return cgs_map_hash_fold(cgs_map_hash64(&k, sizeof(cgs_hash_key)));
+}
+#undef cgs_map_default_hash_fast
+#endif
+
+#ifdef cgs_map_default_hash_str_fast
+static inline uint32_t cgs_hash_name(cgs_hash_key k) {
+    return cgs_map_hash_fold(cgs_map_hash_str64(k));
+}
+#undef cgs_map_default_hash_str_fast
+#endif
+
+#ifdef cgs_map_default_hash_ptr_fast
+static inline uint32_t cgs_hash_name(cgs_hash_key k) {
+    return cgs_map_hash_fold(cgs_map_hash64(k, sizeof(*k)));
+}
+#undef cgs_map_default_hash_ptr_fast
+#endif
+
+#undef CGS_HASH_INT
+#undef cgs_map_int_hash_identity
+#undef cgs_map_int_hash_fibonacci
+#undef cgs_hash_key
+#undef cgs_hash_name
+#endif /* hash function generation */
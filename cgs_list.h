@@ -6,6 +6,24 @@
  * - cgs_list_name: The name of the generated list type. (e.g. `my_list`)
  * - cgs_list_type: The type of the elements. (e.g. `int`, `char *`)
  *
+ * The following macros are optional.
+ * - cgs_list_pooled: If defined, nodes are allocated from a node pool instead of one malloc() per node.
+ *   Each list created with new() owns a pool, but a pool of type `<cgs_list_name>_pool` may also be shared
+ *   between lists with new_with_pool(). Erased nodes are reused by later insertions.
+ *   Nodes can only be spliced between lists that share the same pool.
+ * - cgs_list_pool_chunk_size: The number of nodes in a pool chunk. (Default: 256)
+ * - cgs_list_malloc(ctx, size), cgs_list_free(ctx, ptr, size): Replace the global allocator hooks
+ *   of cgs_common.h for this list and its node pool.
+ * - cgs_list_intrusive: The name of a `cgs_list_link` member of cgs_list_type. If defined, the list links
+ *   the objects through that member instead of copying them into nodes, and never allocates a node.
+ *   The elements of the list are then pointers to the objects (`cgs_list_type *`), and the nodes are
+ *   the embedded links. An object can be in as many lists at once as it has links.
+ *   Include the header once without defining cgs_list_name to declare `cgs_list_link`.
+ *   cgs_list_intrusive cannot be combined with cgs_list_pooled.
+ * - cgs_list_equals(a, b): Whether two elements are equal, used by find() and unique(). (Default: `(a) == (b)`)
+ * - cgs_list_less(a, b): Whether a is ordered before b. If defined, sort() and merge() are generated.
+ *   For an intrusive list, a and b are pointers to the objects.
+ *
  * After the header is included, define the macro `cgs_<cgs_list_name>` to 1.
  * This is to prevent clashes from multiple includes.
  *
@@ -16,22 +34,43 @@
  * #include "cgs_list.h"
  * #define cgs_dlist 1
  * ```
+ *
+ * The following code generates the type `olist` as an intrusive list of `struct obj`.
+ * ```
+ * #include "cgs_list.h"
+ * struct obj {
+ *     int id;
+ *     cgs_list_link link;
+ * };
+ * #define cgs_list_type struct obj
+ * #define cgs_list_name olist
+ * #define cgs_list_intrusive link
+ * #include "cgs_list.h"
+ * #define cgs_olist 1
+ * ```
  */
 
 #include "cgs_common.h"
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <string.h>
 #include <assert.h>
 
 /* Common macros (include only once) */
 #ifndef CGS_LIST_H
 #define CGS_LIST_H
+/** The links embedded in an object of an intrusive list, which also serve as its node. */
+typedef struct cgs_list_link {
+    struct cgs_list_link *prev, *next;
+} cgs_list_link;
+
 /**
  * @brief Generates a for-each loop.
  *
  * The parameters `n` and `e` are defined inside the macro, so they should not be defined outside.
  * The node variable `n` may be useful for functions such as `XXX_erase()`.
+ * For an intrusive list, `e` is a pointer to the containing object.
  *
  * @param t The name of the list type. (e.g. `my_list`)
  * @param l The list to iterate on.
@@ -39,7 +78,8 @@
  * @param e The variable that holds the current element.
  */
 #define cgs_list_foreach(t, l, n, e) for (CGS_CAT(t, node) *n = CGS_CAT(t, front_node)(l), *n##__n = n->next; n; n = NULL) \
-                                         for (CGS_CAT(t, type) e = n->dat; n != &(l)->root; n = n##__n, n##__n = n->next, e = n->dat)
+                                         for (CGS_CAT(t, type) e = CGS_CAT(t, node_value)(n); n != &(l)->root; \
+                                              n = n##__n, n##__n = n->next, e = CGS_CAT(t, node_value)(n))
 /**
  * @brief Generates a for-each loop that iterates in reverse.
  *
@@ -49,13 +89,28 @@
  * @param e The variable that holds the current element.
  */
 #define cgs_list_foreach_r(t, l, n, e) for (CGS_CAT(t, node) *n = CGS_CAT(t, back_node)(l), *n##__n = n->prev; n; n = NULL) \
-                                           for (CGS_CAT(t, type) e = n->dat; n != &(l)->root; n = n##__n, n##__n = n->prev, e = n->dat)
+                                           for (CGS_CAT(t, type) e = CGS_CAT(t, node_value)(n); n != &(l)->root; \
+                                                n = n##__n, n##__n = n->prev, e = CGS_CAT(t, node_value)(n))
 #define CGS_LIST(name) CGS_CAT(cgs_list_name, name)
+#define CGS_LIST_INTERNAL(name) CGS_CAT_INTERNAL(cgs_list_name, name)
 #endif
 
 /* semi include guard */
-#if !CGS_CAT(cgs, cgs_list_name)
+#if defined(cgs_list_name) && !CGS_CAT(cgs, cgs_list_name)
+
+#if defined(cgs_list_intrusive) && defined(cgs_list_pooled)
+#error "cgs_list_intrusive and cgs_list_pooled cannot be defined at the same time"
+#endif
+
+#ifdef cgs_list_intrusive
+typedef cgs_list_type *CGS_LIST(type);
 
+/**
+ * The links embedded in each object, which serve as the nodes of an intrusive list.
+ * It can be used like a C++ iterator in some functions.
+ */
+typedef cgs_list_link CGS_LIST(node);
+#else
 typedef cgs_list_type CGS_LIST(type);
 
 /**
@@ -66,21 +121,161 @@ typedef struct CGS_LIST(node) {
     cgs_list_type dat;
     struct CGS_LIST(node) *prev, *next;
 } CGS_LIST(node);
+#endif
+
+#ifndef cgs_list_equals
+#define cgs_list_equals(a, b) ((a) == (b))
+#endif
+
+#ifndef cgs_list_malloc
+#define cgs_list_malloc CGS_MALLOC
+#endif
+#ifndef cgs_list_free
+#define cgs_list_free CGS_FREE
+#endif
+
+#ifdef cgs_list_pooled
+#define cgs_pool_type CGS_LIST(node)
+#define cgs_pool_name CGS_LIST(pool)
+#ifdef cgs_list_pool_chunk_size
+#define cgs_pool_chunk_size cgs_list_pool_chunk_size
+#endif
+#define cgs_pool_malloc cgs_list_malloc
+#define cgs_pool_free cgs_list_free
+#include "cgs_pool.h"
+#endif
 
 typedef struct {
     size_t size;
     CGS_LIST(node) root;
+    void *alloc_ctx;
+#ifdef cgs_list_pooled
+    CGS_LIST(pool) *pool;
+    CGS_LIST(pool) own_pool; /* used unless the list was given a shared pool */
+#endif
 } cgs_list_name;
 
+#ifdef cgs_list_pooled
+/**
+ * @brief Initialize a list in place, allocating its nodes from the given pool.
+ * The pool may be shared by multiple lists, and must outlive all of them.
+ * The list uses the allocator context of the pool.
+ * @param l The list to initialize.
+ * @param pool The node pool to use.
+ */
+static inline void CGS_LIST(init_with_pool)(cgs_list_name *l, CGS_LIST(pool) *pool) {
+    l->size = 0;
+    l->root.prev = l->root.next = &l->root;
+    l->alloc_ctx = pool->alloc_ctx;
+    l->pool = pool;
+}
+
+/**
+ * @brief Allocate and initialize a new list that allocates its nodes from the given pool.
+ * The pool may be shared by multiple lists, and must outlive all of them.
+ * The list uses the allocator context of the pool.
+ * @param pool The node pool to use.
+ * @return A newly allocated and initialized list.
+ */
+static inline cgs_list_name *CGS_LIST(new_with_pool)(CGS_LIST(pool) *pool) {
+    cgs_list_name *res = cgs_list_malloc(pool->alloc_ctx, sizeof(cgs_list_name));
+    CGS_LIST(init_with_pool)(res, pool);
+    return res;
+}
+
+/** @private Whether the list allocates from its own pool, rather than a shared one. */
+static inline bool CGS_LIST_INTERNAL(owns_pool)(cgs_list_name *l) {
+    return l->pool == &l->own_pool;
+}
+#endif
+
+/**
+ * @brief Initialize a list in place, e.g. one embedded in another struct or on the stack.
+ * The list points into itself, so it must not be copied or moved afterwards.
+ * @param l The list to initialize.
+ * @param ctx The context pointer passed to the allocator hooks.
+ */
+static inline void CGS_LIST(init)(cgs_list_name *l, void *ctx) {
+#ifdef cgs_list_pooled
+    CGS_LIST(pool_init)(&l->own_pool, ctx);
+    CGS_LIST(init_with_pool)(l, &l->own_pool);
+#else
+    l->size = 0;
+    l->root.prev = l->root.next = &l->root;
+    l->alloc_ctx = ctx;
+#endif
+}
+
+/**
+ * @brief Allocate and initialize a new list that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized list.
+ */
+static inline cgs_list_name *CGS_LIST(new_with_ctx)(void *ctx) {
+    cgs_list_name *res = cgs_list_malloc(ctx, sizeof(cgs_list_name));
+    CGS_LIST(init)(res, ctx);
+    return res;
+}
+
 /**
  * @brief Allocate and initialize a new list.
  * @return A newly allocated and initialized list.
  */
 static inline cgs_list_name *CGS_LIST(new)() {
-    cgs_list_name *res = malloc(sizeof(cgs_list_name));
-    res->size = 0;
-    res->root.prev = res->root.next = &res->root;
-    return res;
+    return CGS_LIST(new_with_ctx)(NULL);
+}
+
+/**
+ * @brief Returns the element of a node.
+ * For an intrusive list, this is the object that contains the node.
+ * @param n The node to query. Must not be the sentinel node.
+ * @return The element of the node.
+ */
+static inline CGS_LIST(type) CGS_LIST(node_value)(CGS_LIST(node) *n) {
+#ifdef cgs_list_intrusive
+    return (CGS_LIST(type)) ((char *) n - offsetof(cgs_list_type, cgs_list_intrusive));
+#else
+    return n->dat;
+#endif
+}
+
+#ifdef cgs_list_intrusive
+/**
+ * @brief Returns the node embedded in an object of an intrusive list.
+ * @param e The object to query.
+ * @return The node of the object.
+ */
+static inline CGS_LIST(node) *CGS_LIST(node_of)(CGS_LIST(type) e) {
+    return &e->cgs_list_intrusive;
+}
+#endif
+
+/** @private Returns a node that holds the element, allocating one unless the list is intrusive. */
+static inline CGS_LIST(node) *CGS_LIST_INTERNAL(make_node)(cgs_list_name *l, CGS_LIST(type) e) {
+#ifdef cgs_list_intrusive
+    (void) l;
+    return CGS_LIST(node_of)(e);
+#else
+#ifdef cgs_list_pooled
+    CGS_LIST(node) *node = CGS_LIST(pool_alloc)(l->pool);
+#else
+    CGS_LIST(node) *node = cgs_list_malloc(l->alloc_ctx, sizeof(CGS_LIST(node)));
+#endif
+    node->dat = e;
+    return node;
+#endif
+}
+
+/** @private Frees a node made with make_node. Nodes of an intrusive list are only unlinked. */
+static inline void CGS_LIST_INTERNAL(free_node)(cgs_list_name *l, CGS_LIST(node) *n) {
+#if defined(cgs_list_intrusive)
+    (void) l;
+    (void) n;
+#elif defined(cgs_list_pooled)
+    CGS_LIST(pool_release)(l->pool, n);
+#else
+    cgs_list_free(l->alloc_ctx, n, sizeof(CGS_LIST(node)));
+#endif
 }
 
 /**
@@ -100,9 +295,8 @@ static inline bool CGS_LIST(empty)(cgs_list_name *l) {
  * @param e The element to insert.
  * @return The newly created node with the inserted element.
  */
-static inline CGS_LIST(node) *CGS_LIST(insert_after)(cgs_list_name *l, CGS_LIST(node) *n, cgs_list_type e) {
-    CGS_LIST(node) *node = malloc(sizeof(CGS_LIST(node)));
-    node->dat = e;
+static inline CGS_LIST(node) *CGS_LIST(insert_after)(cgs_list_name *l, CGS_LIST(node) *n, CGS_LIST(type) e) {
+    CGS_LIST(node) *node = CGS_LIST_INTERNAL(make_node)(l, e);
 
     node->next = n->next;
     n->next->prev = node;
@@ -122,9 +316,8 @@ static inline CGS_LIST(node) *CGS_LIST(insert_after)(cgs_list_name *l, CGS_LIST(
  * @param e The element to insert.
  * @return The newly created node with the inserted element.
  */
-static inline CGS_LIST(node) *CGS_LIST(insert_before)(cgs_list_name *l, CGS_LIST(node) *n, cgs_list_type e) {
-    CGS_LIST(node) *node = malloc(sizeof(CGS_LIST(node)));
-    node->dat = e;
+static inline CGS_LIST(node) *CGS_LIST(insert_before)(cgs_list_name *l, CGS_LIST(node) *n, CGS_LIST(type) e) {
+    CGS_LIST(node) *node = CGS_LIST_INTERNAL(make_node)(l, e);
 
     node->prev = n->prev;
     n->prev->next = node;
@@ -138,6 +331,7 @@ static inline CGS_LIST(node) *CGS_LIST(insert_before)(cgs_list_name *l, CGS_LIST
 
 /**
  * Erase a node in the list.
+ * For an intrusive list, the node is only unlinked, and the object is left to the caller.
  * @param l The list to modify.
  * @param n The node to erase.
  */
@@ -146,11 +340,36 @@ static inline void CGS_LIST(erase)(cgs_list_name *l, CGS_LIST(node) *n) {
 
     n->next->prev = n->prev;
     n->prev->next = n->next;
-    free(n);
+    CGS_LIST_INTERNAL(free_node)(l, n);
 
     l->size--;
 }
 
+#ifdef cgs_list_intrusive
+/**
+ * @brief Unlink an object from the intrusive list in O(1).
+ * @param l The list to modify. The object must be an element of this list.
+ * @param e The object to unlink.
+ */
+static inline void CGS_LIST(unlink)(cgs_list_name *l, CGS_LIST(type) e) {
+    CGS_LIST(erase)(l, CGS_LIST(node_of)(e));
+}
+#endif
+
+/** @private Moves the nodes from first up to (but excluding) last before pos. The sizes are left to the caller. */
+static inline void CGS_LIST_INTERNAL(transfer)(CGS_LIST(node) *pos, CGS_LIST(node) *first, CGS_LIST(node) *last) {
+    CGS_LIST(node) *end = last->prev;
+
+    first->prev->next = last;
+    last->prev = first->prev;
+
+    first->prev = pos->prev;
+    pos->prev->next = first;
+
+    end->next = pos;
+    pos->prev = end;
+}
+
 /**
  * @brief Splice together two lists.
  * All the elements of list f are moved to the list t after the node pos.
@@ -164,13 +383,7 @@ static inline void CGS_LIST(splice_after)(cgs_list_name *t, CGS_LIST(node) *pos,
         return;
     }
 
-    pos->next->prev = f->root.prev;
-    f->root.prev->next = pos->next;
-
-    pos->next = f->root.next;
-    f->root.next->prev = pos;
-
-    f->root.next = f->root.prev = &f->root;
+    CGS_LIST_INTERNAL(transfer)(pos->next, f->root.next, &f->root);
 
     t->size += f->size;
     f->size = 0;
@@ -189,13 +402,7 @@ static inline void CGS_LIST(splice_before)(cgs_list_name *t, CGS_LIST(node) *pos
         return;
     }
 
-    pos->prev->next = f->root.next;
-    f->root.next->prev = pos->prev;
-
-    pos->prev = f->root.prev;
-    f->root.prev->next = pos;
-
-    f->root.next = f->root.prev = &f->root;
+    CGS_LIST_INTERNAL(transfer)(pos, f->root.next, &f->root);
 
     t->size += f->size;
     f->size = 0;
@@ -206,17 +413,65 @@ static inline void CGS_LIST(splice_before)(cgs_list_name *t, CGS_LIST(node) *pos
  * @param l The list to modify.
  * @param e The element to push.
  */
-static inline void CGS_LIST(push_back)(cgs_list_name *l, cgs_list_type e) {
+static inline void CGS_LIST(push_back)(cgs_list_name *l, CGS_LIST(type) e) {
     CGS_LIST(insert_before)(l, &l->root, e);
 }
 
+#ifndef cgs_list_intrusive
+/**
+ * @brief Pushes n copies of an element to the end of the list.
+ * If the list is pooled, the nodes are reserved from the pool all at once.
+ * @param l The list to modify.
+ * @param n The number of elements to push.
+ * @param e The element to push.
+ */
+static inline void CGS_LIST(push_back_n)(cgs_list_name *l, size_t n, cgs_list_type e) {
+    CGS_LIST(node) *last = l->root.prev;
+#ifdef cgs_list_pooled
+    CGS_LIST(pool_reserve)(l->pool, n);
+#endif
+    for (size_t i = 0; i < n; i++) {
+        CGS_LIST(node) *node = CGS_LIST_INTERNAL(make_node)(l, e);
+        node->prev = last;
+        last->next = node;
+        last = node;
+    }
+    last->next = &l->root;
+    l->root.prev = last;
+    l->size += n;
+}
+#endif
+
+/**
+ * @brief Pushes the elements of an array to the end of the list, in order.
+ * If the list is pooled, the nodes are reserved from the pool all at once.
+ * @param l The list to modify.
+ * @param arr The elements to push.
+ * @param n The number of elements in arr.
+ */
+static inline void CGS_LIST(append_array)(cgs_list_name *l, const CGS_LIST(type) *arr, size_t n) {
+    CGS_LIST(node) *last = l->root.prev;
+#ifdef cgs_list_pooled
+    CGS_LIST(pool_reserve)(l->pool, n);
+#endif
+    for (size_t i = 0; i < n; i++) {
+        CGS_LIST(node) *node = CGS_LIST_INTERNAL(make_node)(l, arr[i]);
+        node->prev = last;
+        last->next = node;
+        last = node;
+    }
+    last->next = &l->root;
+    l->root.prev = last;
+    l->size += n;
+}
+
 /**
  * @brief Pops an element from the end of the list and returns it.
  * @param l The list to modify.
  * @return The popped element at the end of the list.
  */
-static inline cgs_list_type CGS_LIST(pop_back)(cgs_list_name *l) {
-    cgs_list_type res = l->root.prev->dat;
+static inline CGS_LIST(type) CGS_LIST(pop_back)(cgs_list_name *l) {
+    CGS_LIST(type) res = CGS_LIST(node_value)(l->root.prev);
     CGS_LIST(erase)(l, l->root.prev);
     return res;
 }
@@ -226,7 +481,7 @@ static inline cgs_list_type CGS_LIST(pop_back)(cgs_list_name *l) {
  * @param l The list to modify.
  * @param e The element to push.
  */
-static inline void CGS_LIST(push_front)(cgs_list_name *l, cgs_list_type e) {
+static inline void CGS_LIST(push_front)(cgs_list_name *l, CGS_LIST(type) e) {
     CGS_LIST(insert_after)(l, &l->root, e);
 }
 
@@ -235,8 +490,8 @@ static inline void CGS_LIST(push_front)(cgs_list_name *l, cgs_list_type e) {
  * @param l The list to modify.
  * @return The popped element at the front of the list.
  */
-static inline cgs_list_type CGS_LIST(pop_front)(cgs_list_name *l) {
-    cgs_list_type res = l->root.next->dat;
+static inline CGS_LIST(type) CGS_LIST(pop_front)(cgs_list_name *l) {
+    CGS_LIST(type) res = CGS_LIST(node_value)(l->root.next);
     CGS_LIST(erase)(l, l->root.next);
     return res;
 }
@@ -278,9 +533,9 @@ static inline CGS_LIST(node) *CGS_LIST(sentinel_node)(cgs_list_name *l) {
  * @param e The element to find.
  * @return The node that represents the first element identical to e.
  */
-static inline CGS_LIST(node) *CGS_LIST(find)(cgs_list_name *l, cgs_list_type e) {
+static inline CGS_LIST(node) *CGS_LIST(find)(cgs_list_name *l, CGS_LIST(type) e) {
     CGS_LIST(node) *n = l->root.next;
-    while (n != &l->root && n->dat != e) {
+    while (n != &l->root && !cgs_list_equals(CGS_LIST(node_value)(n), e)) {
         n = n->next;
     }
     return n;
@@ -288,51 +543,201 @@ static inline CGS_LIST(node) *CGS_LIST(find)(cgs_list_name *l, cgs_list_type e)
 
 /**
  * @brief Returns the first element in the list.
- * Equivalent to front_node()->dat.
+ * Equivalent to node_value(front_node()).
  * @param l The list to query.
  * @return The first element of the list.
  */
-static inline cgs_list_type CGS_LIST(front)(cgs_list_name *l) {
+static inline CGS_LIST(type) CGS_LIST(front)(cgs_list_name *l) {
     assert(l->size > 0);
-    return l->root.next->dat;
+    return CGS_LIST(node_value)(l->root.next);
 }
 
 /**
  * @brief Returns the last element in the list.
- * Equivalent to back_node()->dat.
+ * Equivalent to node_value(back_node()).
  * @param l The list to query.
  * @return The last element of the list.
  */
-static inline cgs_list_type CGS_LIST(back)(cgs_list_name *l) {
+static inline CGS_LIST(type) CGS_LIST(back)(cgs_list_name *l) {
     assert(l->size > 0);
-    return l->root.prev->dat;
+    return CGS_LIST(node_value)(l->root.prev);
+}
+
+/**
+ * @brief Removes consecutive duplicate elements, keeping the first of each run.
+ * On a sorted list, this leaves only unique elements.
+ * @param l The list to modify.
+ * @return The number of elements that were removed.
+ */
+static inline size_t CGS_LIST(unique)(cgs_list_name *l) {
+    CGS_LIST(node) *n = l->root.next, *next;
+    size_t removed = 0;
+    if (n == &l->root) {
+        return 0;
+    }
+    for (next = n->next; next != &l->root; next = n->next) {
+        if (cgs_list_equals(CGS_LIST(node_value)(n), CGS_LIST(node_value)(next))) {
+            CGS_LIST(erase)(l, next);
+            removed++;
+        } else {
+            n = next;
+        }
+    }
+    return removed;
+}
+
+#ifdef cgs_list_less
+/**
+ * @brief Merge a sorted list into another sorted list.
+ * The nodes of f are relinked into t, so the merge is stable and does not allocate.
+ * If the lists are pooled, they must share the same pool. After the operation, the list f becomes empty.
+ * @param t The sorted list to merge into.
+ * @param f The sorted list to merge from. Its elements are placed after equal elements of t.
+ */
+static inline void CGS_LIST(merge)(cgs_list_name *t, cgs_list_name *f) {
+    CGS_LIST(node) *a = t->root.next, *b = f->root.next, *last;
+    while (a != &t->root && b != &f->root) {
+        if (cgs_list_less(CGS_LIST(node_value)(b), CGS_LIST(node_value)(a))) {
+            /* move the whole run of f that goes before a at once */
+            last = b->next;
+            while (last != &f->root && cgs_list_less(CGS_LIST(node_value)(last), CGS_LIST(node_value)(a))) {
+                last = last->next;
+            }
+            CGS_LIST_INTERNAL(transfer)(a, b, last);
+            b = last;
+        } else {
+            a = a->next;
+        }
+    }
+    if (b != &f->root) {
+        CGS_LIST_INTERNAL(transfer)(&t->root, b, &f->root);
+    }
+    t->size += f->size;
+    f->size = 0;
+}
+
+/** @private Merges two sorted NULL-terminated chains linked only by next, preferring a on ties. */
+static inline CGS_LIST(node) *CGS_LIST_INTERNAL(merge_chains)(CGS_LIST(node) *a, CGS_LIST(node) *b) {
+    CGS_LIST(node) *res, **tail = &res;
+    while (a != NULL && b != NULL) {
+        if (cgs_list_less(CGS_LIST(node_value)(b), CGS_LIST(node_value)(a))) {
+            *tail = b;
+            tail = &b->next;
+            b = b->next;
+        } else {
+            *tail = a;
+            tail = &a->next;
+            a = a->next;
+        }
+    }
+    *tail = a != NULL ? a : b;
+    return res;
+}
+
+/**
+ * @brief Sort the list with a stable bottom-up merge sort in O(n log n).
+ * Only the links of the nodes are changed, so the sort does not allocate and nodes stay valid.
+ * @param l The list to sort.
+ */
+static inline void CGS_LIST(sort)(cgs_list_name *l) {
+    /* runs[i] is empty or a sorted chain of 2^i nodes, which precede the nodes of runs[j] for j < i */
+    CGS_LIST(node) *runs[sizeof(size_t) * 8] = {NULL};
+    CGS_LIST(node) *n, *next, *prev;
+    size_t i, count = 0;
+    if (l->size < 2) {
+        return;
+    }
+    l->root.prev->next = NULL;
+    for (n = l->root.next; n != NULL; n = next) {
+        next = n->next;
+        n->next = NULL;
+        for (i = 0; runs[i] != NULL; i++) {
+            n = CGS_LIST_INTERNAL(merge_chains)(runs[i], n);
+            runs[i] = NULL;
+        }
+        runs[i] = n;
+        count = i + 1 > count ? i + 1 : count;
+    }
+    n = NULL;
+    for (i = 0; i < count; i++) {
+        if (runs[i] != NULL) {
+            n = n != NULL ? CGS_LIST_INTERNAL(merge_chains)(runs[i], n) : runs[i];
+        }
+    }
+    /* restore the prev links and close the circle */
+    l->root.next = n;
+    prev = &l->root;
+    for (; n != NULL; n = n->next) {
+        n->prev = prev;
+        prev = n;
+    }
+    prev->next = &l->root;
+    l->root.prev = prev;
 }
+#endif
 
 /**
  * @brief Removes all elements from the list.
+ * If the list owns its node pool, the whole pool is reset at once.
+ * An intrusive list only forgets its objects, without touching them.
  * @param l The list to clear.
  */
 static inline void CGS_LIST(clear)(cgs_list_name *l) {
+#ifdef cgs_list_intrusive
+    l->root.next = l->root.prev = &l->root;
+    l->size = 0;
+    return;
+#endif
+#ifdef cgs_list_pooled
+    if (CGS_LIST_INTERNAL(owns_pool)(l)) {
+        CGS_LIST(pool_reset)(l->pool);
+        l->root.next = l->root.prev = &l->root;
+        l->size = 0;
+        return;
+    }
+#endif
     CGS_LIST(node) *curr = l->root.next, *next;
     while (curr != &l->root) {
         next = curr->next;
-        free(curr);
+        CGS_LIST_INTERNAL(free_node)(l, curr);
         curr = next;
     }
     l->root.next = l->root.prev = &l->root;
     l->size = 0;
 }
 
+/**
+ * @brief Frees the data structures of a list initialized with init(), but not the list itself.
+ * The list must be initialized again before it is used.
+ * @param l The list to destroy.
+ */
+static inline void CGS_LIST(destroy)(cgs_list_name *l) {
+#ifdef cgs_list_pooled
+    if (CGS_LIST_INTERNAL(owns_pool)(l)) {
+        CGS_LIST(pool_destroy)(l->pool);
+        return;
+    }
+#endif
+    CGS_LIST(clear)(l);
+}
+
 /**
  * @brief Frees the list and all of its data structures.
  * If the list is not empty, it is cleared first.
  * @param l The list to free.
  */
 static inline void CGS_LIST(free)(cgs_list_name *l) {
-    CGS_LIST(clear)(l);
-    free(l);
+    CGS_LIST(destroy)(l);
+    cgs_list_free(l->alloc_ctx, l, sizeof(cgs_list_name));
 }
 
 #undef cgs_list_type
 #undef cgs_list_name
+#undef cgs_list_pooled
+#undef cgs_list_pool_chunk_size
+#undef cgs_list_malloc
+#undef cgs_list_free
+#undef cgs_list_intrusive
+#undef cgs_list_equals
+#undef cgs_list_less
 #endif /* semi include guard */
@@ -9,11 +9,35 @@
  * - cgs_map_initial_capacity: Optional. The initial capacity of the map. (Default: 16)
  * - cgs_map_default_value: Optional. The default value returned when the element is not found. (Default: 0)
  * - cgs_map_load_factor: Optional. The target load factor as an integer percentage. (Default: 75)
+ * - cgs_map_min_load_factor: Optional. If positive, buckets are merged back as entries are erased, until the load
+ *   factor is at least this integer percentage. It should be well below half of cgs_map_load_factor, so that
+ *   inserting and erasing around the threshold does not split and merge the same bucket repeatedly. (Default: 0)
+ * - cgs_map_pooled: Optional. If defined, entries are allocated from a per-map pool of large chunks instead of
+ *   one malloc() per entry. Erased entries are recycled, and clear/free release whole chunks at once.
+ * - cgs_map_pool_chunk_size: Optional. The number of entries in a pool chunk. (Default: 256)
+ * - cgs_map_compact: Optional. If defined, entries are only linked through their bucket chains, and the
+ *   list of all entries in insertion order is dropped. This saves two pointers per entry, but clearing
+ *   the map walks the buckets instead of the entry list.
+ * - cgs_map_malloc(ctx, size), cgs_map_realloc(ctx, ptr, old_size, size), cgs_map_free(ctx, ptr, size):
+ *   Optional. Replace the global allocator hooks of cgs_common.h for this map, including its bucket array.
  *
- * The following three macros define the hashing function used. Only one must be defined.
+ * The entries can be visited with cgs_map_foreach(), or with begin() and next(). The order depends on the mode:
+ * pooled maps walk their chunks in memory order, compact maps walk their buckets, and other maps follow
+ * the insertion order.
+ *
+ * The following macros define the hashing function used. Only one must be defined.
  * - cgs_map_default_hash: The default hash function, suitable for basic key types like `int` or `long`.
  * - cgs_map_default_hash_str: The default hash function for null-terminated strings.
  * - cgs_map_default_hash_ptr: The default hash function for pointers to data with a fixed size.
+ * - cgs_map_default_hash_fast, cgs_map_default_hash_str_fast, cgs_map_default_hash_ptr_fast:
+ *   The same as above, but with the 64-bit cgs_map_hash64(), which reads 8 bytes at a time.
+ *   Recommended for large keys and strings longer than a few characters.
+ *
+ * With cgs_map_default_hash or cgs_map_default_hash_fast, keys of 1, 2, 4 or 8 bytes are hashed as integers
+ * without any loops. The integer hashing strategy can be chosen with one of the following macros.
+ * - (none): A 64-bit mixer. (cgs_map_hash_int_mix)
+ * - cgs_map_int_hash_fibonacci: A single multiplication. (cgs_map_hash_int_fibonacci)
+ * - cgs_map_int_hash_identity: The key itself, for keys that are already random. (cgs_map_hash_int_identity)
  *
  * The default hashing functions do not support pointers to variable length data.
  * Instead, the hashing function must be manually defined with the following signature prior to including
@@ -40,73 +64,34 @@
  */
 
 #include "cgs_common.h"
+#include "cgs_hash.h"
 #include <stdlib.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
 #include <assert.h>
 
-/* Common functions (include only once) */
+/* Common macros (include only once) */
 #ifndef CGS_MAP_H
 #define CGS_MAP_H
 
 /**
- * @brief Hash a single 32-bit integer.
- * The algorithm from https://github.com/skeeto/hash-prospector is used.
- * @param x The integer to hash.
- * @return The hash result.
- */
-static inline uint32_t cgs_map_hash_single(uint32_t x) {
-    // https://github.com/skeeto/hash-prospector
-    x ^= x >> 15;
-    x *= 0xd168aaad;
-    x ^= x >> 15;
-    x *= 0xaf723597;
-    x ^= x >> 15;
-    return x;
-}
-
-/**
- * @brief Hash the given data.
- * @param ptr The pointer to the data.
- * @param size The size of the data.
- * @return The hash result.
- */
-static inline uint32_t cgs_map_hash(const void *ptr, size_t size) {
-    uint32_t res = 1;
-    while (size & 3) { // size % 4
-        res <<= 8;
-        res |= ((char *) ptr)[size - 1];
-        size--;
-    }
-    res = cgs_map_hash_single(res);
-    for (size_t i = 0; i < size / 4; i++) {
-        res ^= ((uint32_t *) ptr)[i];
-        res = cgs_map_hash_single(res);
-    }
-    return res;
-}
-
-/**
- * @brief Hash the given string.
- * @param ptr The string to hash.
- * @return The hash result.
+ * @brief Generates a for-each loop over the entries of the map.
+ *
+ * The parameters `k` and `v` are defined inside the macro, so they should not be defined outside.
+ * They hold copies of the key and the value of the current entry.
+ * The map must not be modified inside the loop. `break` and `continue` work as in a plain loop.
+ *
+ * @param t The name of the map type. (e.g. `my_map`)
+ * @param m The map to iterate on.
+ * @param k The variable that holds the current key.
+ * @param v The variable that holds the current value.
  */
-static inline uint32_t cgs_map_hash_str(const char *ptr) {
-    uint32_t res = 1;
-    while(ptr[0] != 0) {
-        uint32_t next = 1;
-        for (int i = 0; i < 4 && ptr[0] != 0; i++) { // size % 4
-            next <<= 8;
-            next |= ptr[0];
-            ptr++;
-        }
-        res ^= next;
-        res = cgs_map_hash_single(res);
-    }
-    return res;
-}
-
+#define cgs_map_foreach(t, m, k, v) \
+    for (CGS_CAT(t, iter) k##__it, *k##__b = (CGS_CAT(t, begin)(m, &k##__it), NULL); k##__it.entry; k##__it.entry = NULL) \
+        for (CGS_CAT(t, key) k; k##__it.entry && (k = k##__it.entry->key, 1); \
+             k##__it.entry = k##__b ? NULL : CGS_CAT(t, next)(m, &k##__it)) \
+            for (CGS_CAT(t, value) v = (k##__b = &k##__it, k##__it.entry->value); k##__b; k##__b = NULL)
 #define CGS_MAP(name) CGS_CAT(cgs_map_name, name)
 #define CGS_MAP_INTERNAL(name) CGS_CAT_INTERNAL(cgs_map_name, name)
 
@@ -130,66 +115,122 @@ typedef cgs_map_value CGS_MAP(value);
 #define cgs_map_load_factor 75
 #endif
 
+#ifndef cgs_map_min_load_factor
+#define cgs_map_min_load_factor 0
+#endif
+
 typedef struct CGS_MAP(entry) {
     cgs_map_key key;
     uint32_t hash;
     cgs_map_value value;
-    struct CGS_MAP(entry) *next_in_bucket, *prev_in_bucket;
-    struct CGS_MAP(entry) *next, *prev;
+    struct CGS_MAP(entry) *next_in_bucket;
+#ifndef cgs_map_compact
+    struct CGS_MAP(entry) *next, *prev; /* list of all entries in insertion order */
+#endif
 } CGS_MAP(entry);
 
+#ifndef cgs_map_malloc
+#define cgs_map_malloc CGS_MALLOC
+#endif
+#ifndef cgs_map_realloc
+#define cgs_map_realloc CGS_REALLOC
+#endif
+#ifndef cgs_map_free
+#define cgs_map_free CGS_FREE
+#endif
+
 #define cgs_vec_type CGS_MAP(entry) *
 #define cgs_vec_name CGS_MAP_INTERNAL(vec)
+#define cgs_vec_malloc cgs_map_malloc
+#define cgs_vec_realloc cgs_map_realloc
+#define cgs_vec_free cgs_map_free
 #include "cgs_vector.h"
 
-#ifdef cgs_map_default_hash_str
-static inline uint32_t CGS_MAP(hash)(cgs_map_key k) {
-    return cgs_map_hash_str(k);
-}
-#undef cgs_map_default_hash_str
+#ifdef cgs_map_pooled
+#define cgs_pool_type CGS_MAP(entry)
+#define cgs_pool_name CGS_MAP_INTERNAL(pool)
+#ifdef cgs_map_pool_chunk_size
+#define cgs_pool_chunk_size cgs_map_pool_chunk_size
 #endif
-
-#ifdef cgs_map_default_hash_ptr
-static inline uint32_t CGS_MAP(hash)(cgs_map_key k) {
-    return cgs_map_hash(k, sizeof(*k));
-}
-#undef cgs_map_default_hash_ptr
+#define cgs_pool_malloc cgs_map_malloc
+#define cgs_pool_free cgs_map_free
+#include "cgs_pool.h"
 #endif
 
-#ifdef cgs_map_default_hash
-static inline uint32_t CGS_MAP(hash)(cgs_map_key k) {
-    return cgs_map_hash(&k, sizeof(cgs_map_key));
-}
-#undef cgs_map_default_hash
+#define cgs_hash_key cgs_map_key
+#define cgs_hash_name CGS_MAP(hash)
+#include "cgs_hash.h"
+
+/** A cursor over the entries of the map. `entry` is the current entry, or NULL past the last one. */
+typedef struct {
+    CGS_MAP(entry) *entry;
+#if defined(cgs_map_pooled)
+    CGS_CAT(CGS_MAP_INTERNAL(pool), chunk) *chunk;
+    size_t index;
+#elif defined(cgs_map_compact)
+    size_t bucket;
 #endif
+} CGS_MAP(iter);
 
 typedef struct {
     size_t size;
     size_t hash_base;
     size_t split_index;
-    CGS_MAP_INTERNAL(vec) *vec;
+    CGS_MAP_INTERNAL(vec) vec;
+#ifndef cgs_map_compact
     CGS_MAP(entry) root;
+#endif
+    void *alloc_ctx;
+#ifdef cgs_map_pooled
+    CGS_MAP_INTERNAL(pool) pool;
+#else
+    CGS_MAP(entry) *free_list; /* entries kept by reset() for later insertions */
+#endif
 } cgs_map_name;
 
 /**
- * @brief Allocates and initializes a new map.
- * @return A newly allocated and initialized map.
+ * @brief Initializes a map in place, e.g. one embedded in another struct or on the stack.
+ * Unless cgs_map_compact is defined, the map points into itself, so it must not be copied or moved afterwards.
+ * @param m The map to initialize.
+ * @param ctx The context pointer passed to the allocator hooks.
  */
-static inline cgs_map_name *CGS_MAP(new)() {
-    cgs_map_name *m = malloc(sizeof(cgs_map_name));
-    m->vec = CGS_MAP_INTERNAL(vec_new)();
-    CGS_MAP_INTERNAL(vec_reserve)(m->vec, cgs_map_initial_capacity);
-    for (size_t i = 0; i < cgs_map_initial_capacity; i++) {
-        CGS_MAP_INTERNAL(vec_push_back)(m->vec, NULL);
-    }
+static inline void CGS_MAP(init)(cgs_map_name *m, void *ctx) {
+    m->alloc_ctx = ctx;
+    CGS_MAP_INTERNAL(vec_init)(&m->vec, ctx);
+    CGS_MAP_INTERNAL(vec_resize)(&m->vec, cgs_map_initial_capacity, NULL);
+#ifndef cgs_map_compact
     m->root.next = m->root.prev = &m->root;
+#endif
+#ifdef cgs_map_pooled
+    CGS_MAP_INTERNAL(pool_init)(&m->pool, ctx);
+#else
+    m->free_list = NULL;
+#endif
 
     m->hash_base = cgs_map_initial_capacity;
     m->size = 0;
     m->split_index = 0;
+}
+
+/**
+ * @brief Allocates and initializes a new map that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized map.
+ */
+static inline cgs_map_name *CGS_MAP(new_with_ctx)(void *ctx) {
+    cgs_map_name *m = cgs_map_malloc(ctx, sizeof(cgs_map_name));
+    CGS_MAP(init)(m, ctx);
     return m;
 }
 
+/**
+ * @brief Allocates and initializes a new map.
+ * @return A newly allocated and initialized map.
+ */
+static inline cgs_map_name *CGS_MAP(new)() {
+    return CGS_MAP(new_with_ctx)(NULL);
+}
+
 /** @private Maps the 32-bit hash to the length of the map's backing vector. */
 static inline size_t CGS_MAP_INTERNAL(normalize_hash)(cgs_map_name *m, uint32_t hash) {
     size_t low_hash = hash & (m->hash_base - 1);
@@ -200,38 +241,72 @@ static inline size_t CGS_MAP_INTERNAL(normalize_hash)(cgs_map_name *m, uint32_t
 }
 /** @private Finds the entry with the given key in a bucket. */
 static inline CGS_MAP(entry) *CGS_MAP_INTERNAL(find_entry)(cgs_map_name *m, size_t low_hash, cgs_map_key key) {
-    CGS_MAP(entry) *entry = CGS_MAP_INTERNAL(vec_at)(m->vec, low_hash);
+    CGS_MAP(entry) *entry = CGS_MAP_INTERNAL(vec_at)(&m->vec, low_hash);
     while (entry != NULL && entry->key != key) {
         entry = entry->next_in_bucket;
     }
     return entry;
 }
 
+/** @private Allocates an uninitialized entry. */
+static inline CGS_MAP(entry) *CGS_MAP_INTERNAL(alloc_entry)(cgs_map_name *m) {
+#ifdef cgs_map_pooled
+    return CGS_MAP_INTERNAL(pool_alloc)(&m->pool);
+#else
+    CGS_MAP(entry) *entry = m->free_list;
+    if (entry != NULL) {
+#ifdef cgs_map_compact
+        m->free_list = entry->next_in_bucket;
+#else
+        m->free_list = entry->next;
+#endif
+        return entry;
+    }
+    return cgs_map_malloc(m->alloc_ctx, sizeof(CGS_MAP(entry)));
+#endif
+}
+
+/** @private Frees an entry allocated with alloc_entry. */
+static inline void CGS_MAP_INTERNAL(free_entry)(cgs_map_name *m, CGS_MAP(entry) *entry) {
+#ifdef cgs_map_pooled
+    /*
+     * Mark the slot as dead for iteration, which walks every slot of the chunks.
+     * The pool only overwrites the start of the slot, which is before next_in_bucket.
+     */
+    entry->next_in_bucket = entry;
+    CGS_MAP_INTERNAL(pool_release)(&m->pool, entry);
+#else
+    cgs_map_free(m->alloc_ctx, entry, sizeof(CGS_MAP(entry)));
+#endif
+}
+
+#ifndef cgs_map_compact
 /** @private Inserts an entry to the global list. */
 static inline void CGS_MAP_INTERNAL(insert_entry)(cgs_map_name *m, CGS_MAP(entry) *entry) {
     entry->prev = m->root.prev;
     entry->next = &m->root;
     entry->prev->next = entry->next->prev = entry;
 }
+#endif
 
 /** @private Splits a bucket with linear hashing. */
 static inline void CGS_MAP_INTERNAL(split)(cgs_map_name *m) {
-    CGS_MAP_INTERNAL(vec_push_back)(m->vec, NULL);
+    CGS_MAP_INTERNAL(vec_push_back)(&m->vec, NULL);
 
     /* the entry to split */
-    CGS_MAP(entry) *entry = CGS_MAP_INTERNAL(vec_at)(m->vec, m->split_index);
+    CGS_MAP(entry) *entry = CGS_MAP_INTERNAL(vec_at)(&m->vec, m->split_index);
     CGS_MAP(entry) *prev_in_old_bucket = NULL;
 
     while (entry != NULL) {
         CGS_MAP(entry) *next_in_bucket = entry->next_in_bucket;
         uint32_t new_hash = entry->hash & (m->hash_base * 2 - 1);
         if (new_hash != m->split_index) { /* move to new bucket */
-            entry->next_in_bucket = CGS_MAP_INTERNAL(vec_at)(m->vec, new_hash);
-            CGS_MAP_INTERNAL(vec_set)(m->vec, new_hash, entry);
+            entry->next_in_bucket = CGS_MAP_INTERNAL(vec_at)(&m->vec, new_hash);
+            CGS_MAP_INTERNAL(vec_set)(&m->vec, new_hash, entry);
 
             /* remove from old bucket */
             if (prev_in_old_bucket == NULL) {
-                CGS_MAP_INTERNAL(vec_set)(m->vec, m->split_index, next_in_bucket);
+                CGS_MAP_INTERNAL(vec_set)(&m->vec, m->split_index, next_in_bucket);
             } else {
                 prev_in_old_bucket->next_in_bucket = next_in_bucket;
             }
@@ -248,15 +323,28 @@ static inline void CGS_MAP_INTERNAL(split)(cgs_map_name *m) {
     }
 }
 
-/**
- * @brief Inserts a key-value pair to the map.
- * If the key already exists, the existing value is modified.
- * @param m The map to use.
- * @param key The key to insert.
- * @param value The value to insert.
- */
-static inline void CGS_MAP(insert)(cgs_map_name *m, cgs_map_key key, cgs_map_value value) {
-    uint32_t hash = CGS_MAP(hash)(key);
+/** @private Merges the last bucket back into the bucket it was split from, undoing the last split. */
+static inline void CGS_MAP_INTERNAL(merge)(cgs_map_name *m) {
+    if (m->split_index == 0) {
+        m->hash_base /= 2;
+        m->split_index = m->hash_base;
+    }
+    m->split_index--;
+
+    /* the last bucket is always the one that was split last */
+    CGS_MAP(entry) *entry = CGS_MAP_INTERNAL(vec_pop_back)(&m->vec);
+    if (entry != NULL) {
+        CGS_MAP(entry) *last = entry;
+        while (last->next_in_bucket != NULL) {
+            last = last->next_in_bucket;
+        }
+        last->next_in_bucket = m->vec.array[m->split_index];
+        m->vec.array[m->split_index] = entry;
+    }
+}
+
+/** @private Inserts a key-value pair whose key hash is already computed. */
+static inline void CGS_MAP_INTERNAL(insert_hash)(cgs_map_name *m, uint32_t hash, cgs_map_key key, cgs_map_value value) {
     size_t low_hash = CGS_MAP_INTERNAL(normalize_hash)(m, hash);
 
     /* check if key already exists */
@@ -266,22 +354,105 @@ static inline void CGS_MAP(insert)(cgs_map_name *m, cgs_map_key key, cgs_map_val
         return;
     }
 
-    CGS_MAP(entry) *new_entry = malloc(sizeof(CGS_MAP(entry)));
+    CGS_MAP(entry) *new_entry = CGS_MAP_INTERNAL(alloc_entry)(m);
+#ifndef cgs_map_compact
     CGS_MAP_INTERNAL(insert_entry)(m, new_entry);
+#endif
 
-    new_entry->next_in_bucket = CGS_MAP_INTERNAL(vec_at)(m->vec, low_hash);
-    CGS_MAP_INTERNAL(vec_set)(m->vec, low_hash, new_entry);
+    new_entry->next_in_bucket = CGS_MAP_INTERNAL(vec_at)(&m->vec, low_hash);
+    CGS_MAP_INTERNAL(vec_set)(&m->vec, low_hash, new_entry);
 
     new_entry->hash = hash;
     new_entry->key = key;
     new_entry->value = value;
 
     m->size++;
-    while (m->vec->size < m->size * 100 / cgs_map_load_factor) {
+    while (m->vec.size < m->size * 100 / cgs_map_load_factor) {
         CGS_MAP_INTERNAL(split)(m);
     }
 }
 
+/**
+ * @brief Inserts a key-value pair to the map.
+ * If the key already exists, the existing value is modified.
+ * @param m The map to use.
+ * @param key The key to insert.
+ * @param value The value to insert.
+ */
+static inline void CGS_MAP(insert)(cgs_map_name *m, cgs_map_key key, cgs_map_value value) {
+    CGS_MAP_INTERNAL(insert_hash)(m, CGS_MAP(hash)(key), key, value);
+}
+
+/**
+ * @brief Prepares the map to hold at least n entries without splitting any buckets.
+ * The bucket array is resized at once, and the existing entries are redistributed in a single pass.
+ * If the map is pooled, room for the new entries is also reserved from the pool.
+ * @param m The map to use.
+ * @param n The number of entries to prepare for.
+ */
+static inline void CGS_MAP(reserve)(cgs_map_name *m, size_t n) {
+    size_t buckets = n * 100 / cgs_map_load_factor;
+#ifdef cgs_map_pooled
+    if (n > m->size) {
+        CGS_MAP_INTERNAL(pool_reserve)(&m->pool, n - m->size);
+    }
+#endif
+    if (buckets <= m->vec.size) {
+        return;
+    }
+
+    /* collect all entries into a single chain */
+    CGS_MAP(entry) *chain = NULL, *entry, *next;
+    for (size_t i = 0; i < m->vec.size; i++) {
+        for (entry = m->vec.array[i]; entry != NULL; entry = next) {
+            next = entry->next_in_bucket;
+            entry->next_in_bucket = chain;
+            chain = entry;
+        }
+    }
+
+    /* equivalent to splitting buckets until there are enough of them */
+    while (m->hash_base * 2 <= buckets) {
+        m->hash_base *= 2;
+    }
+    m->split_index = buckets - m->hash_base;
+    CGS_MAP_INTERNAL(vec_reserve)(&m->vec, buckets);
+    memset(m->vec.array, 0, buckets * sizeof(CGS_MAP(entry) *));
+    m->vec.size = buckets;
+
+    for (entry = chain; entry != NULL; entry = next) {
+        size_t low_hash = CGS_MAP_INTERNAL(normalize_hash)(m, entry->hash);
+        next = entry->next_in_bucket;
+        entry->next_in_bucket = m->vec.array[low_hash];
+        m->vec.array[low_hash] = entry;
+    }
+}
+
+/**
+ * @brief Inserts n key-value pairs to the map.
+ * Equivalent to calling insert() for each pair in order, but the map is reserved once
+ * and all keys are hashed before any entry is linked.
+ * @param m The map to use.
+ * @param keys The keys to insert.
+ * @param values The values to insert, in the same order as the keys.
+ * @param n The number of key-value pairs.
+ */
+static inline void CGS_MAP(insert_bulk)(cgs_map_name *m, const CGS_MAP(key) *keys, const CGS_MAP(value) *values,
+                                        size_t n) {
+    uint32_t *hashes = cgs_map_malloc(m->alloc_ctx, n * sizeof(uint32_t));
+    CGS_MAP(reserve)(m, m->size + n);
+    for (size_t i = 0; i < n; i++) {
+        hashes[i] = CGS_MAP(hash)(keys[i]);
+    }
+    for (size_t i = 0; i < n; i++) {
+        if (i + 8 < n) {
+            CGS_PREFETCH(&m->vec.array[CGS_MAP_INTERNAL(normalize_hash)(m, hashes[i + 8])]);
+        }
+        CGS_MAP_INTERNAL(insert_hash)(m, hashes[i], keys[i], values[i]);
+    }
+    cgs_map_free(m->alloc_ctx, hashes, n * sizeof(uint32_t));
+}
+
 /**
  * @brief Finds the value associated with the given key.
  * If the key is not found, returns the default value defined with `cgs_map_default_value`.
@@ -296,32 +467,33 @@ static inline cgs_map_value CGS_MAP(find)(cgs_map_name *m, cgs_map_key key) {
     return entry == NULL ? (cgs_map_default_value) : entry->value;
 }
 
-/**
- * @brief Erases the entry with the given key and returns the value it was associated with.
- * If the key is not found, returns the default value defined with `cgs_map_default_value`.
- * @param m The map to use.
- * @param key The key to erase.
- * @return The value previously associated with the given key, or the default value.
- */
-static inline cgs_map_value CGS_MAP(erase)(cgs_map_name *m, cgs_map_key key) {
-    uint32_t hash = CGS_MAP(hash)(key);
+/** @private Erases the entry with the given key, whose hash is already computed. */
+static inline cgs_map_value CGS_MAP_INTERNAL(erase_hash)(cgs_map_name *m, uint32_t hash, cgs_map_key key) {
     size_t low_hash = CGS_MAP_INTERNAL(normalize_hash)(m, hash);
 
-    CGS_MAP(entry) *entry = CGS_MAP_INTERNAL(vec_at)(m->vec, low_hash), *prev = NULL;
+    CGS_MAP(entry) *entry = CGS_MAP_INTERNAL(vec_at)(&m->vec, low_hash), *prev = NULL;
     while (entry != NULL) {
         if (entry->key == key) {
             cgs_map_value res = entry->value;
+#ifndef cgs_map_compact
             entry->prev->next = entry->next;
             entry->next->prev = entry->prev;
+#endif
 
             if (prev == NULL) {
-                CGS_MAP_INTERNAL(vec_set)(m->vec, low_hash, entry->next_in_bucket);
+                CGS_MAP_INTERNAL(vec_set)(&m->vec, low_hash, entry->next_in_bucket);
             } else {
                 prev->next_in_bucket = entry->next_in_bucket;
             }
 
-            free(entry);
+            CGS_MAP_INTERNAL(free_entry)(m, entry);
             m->size--;
+#if cgs_map_min_load_factor > 0
+            while (m->vec.size > cgs_map_initial_capacity &&
+                   m->size * 100 < m->vec.size * cgs_map_min_load_factor) {
+                CGS_MAP_INTERNAL(merge)(m);
+            }
+#endif
             return res;
         }
         prev = entry;
@@ -330,29 +502,209 @@ static inline cgs_map_value CGS_MAP(erase)(cgs_map_name *m, cgs_map_key key) {
     return cgs_map_default_value;
 }
 
+/**
+ * @brief Erases the entry with the given key and returns the value it was associated with.
+ * If the key is not found, returns the default value defined with `cgs_map_default_value`.
+ * @param m The map to use.
+ * @param key The key to erase.
+ * @return The value previously associated with the given key, or the default value.
+ */
+static inline cgs_map_value CGS_MAP(erase)(cgs_map_name *m, cgs_map_key key) {
+    return CGS_MAP_INTERNAL(erase_hash)(m, CGS_MAP(hash)(key), key);
+}
+
+#if defined(cgs_map_pooled)
+/** @private Moves the cursor to the first live slot at or after its position. */
+static inline CGS_MAP(entry) *CGS_MAP_INTERNAL(seek)(CGS_MAP(iter) *it) {
+    for (; it->chunk != NULL; it->chunk = it->chunk->next, it->index = 0) {
+        for (; it->index < it->chunk->used; it->index++) {
+            CGS_MAP(entry) *entry = &it->chunk->slots[it->index].dat;
+            if (entry->next_in_bucket != entry) {
+                return it->entry = entry;
+            }
+        }
+    }
+    return it->entry = NULL;
+}
+#elif defined(cgs_map_compact)
+/** @private Moves the cursor to the first entry of the first non-empty bucket at or after its position. */
+static inline CGS_MAP(entry) *CGS_MAP_INTERNAL(seek)(cgs_map_name *m, CGS_MAP(iter) *it) {
+    for (; it->bucket < m->vec.size; it->bucket++) {
+        if (m->vec.array[it->bucket] != NULL) {
+            return it->entry = m->vec.array[it->bucket];
+        }
+    }
+    return it->entry = NULL;
+}
+#endif
+
+/**
+ * @brief Moves a cursor to the first entry of the map.
+ * @param m The map to iterate on.
+ * @param it The cursor to initialize.
+ * @return The first entry, or NULL if the map is empty.
+ */
+static inline CGS_MAP(entry) *CGS_MAP(begin)(cgs_map_name *m, CGS_MAP(iter) *it) {
+#if defined(cgs_map_pooled)
+    it->chunk = m->pool.chunks;
+    it->index = 0;
+    return CGS_MAP_INTERNAL(seek)(it);
+#elif defined(cgs_map_compact)
+    it->bucket = 0;
+    return CGS_MAP_INTERNAL(seek)(m, it);
+#else
+    return it->entry = m->root.next != &m->root ? m->root.next : NULL;
+#endif
+}
+
+/**
+ * @brief Moves a cursor to the next entry of the map.
+ * The map must not be modified between begin() and the last call to next().
+ * @param m The map to iterate on.
+ * @param it The cursor to advance. Its current entry must not be NULL.
+ * @return The next entry, or NULL if there are no more entries.
+ */
+static inline CGS_MAP(entry) *CGS_MAP(next)(cgs_map_name *m, CGS_MAP(iter) *it) {
+#if defined(cgs_map_pooled)
+    (void) m;
+    it->index++;
+    return CGS_MAP_INTERNAL(seek)(it);
+#elif defined(cgs_map_compact)
+    if (it->entry->next_in_bucket != NULL) {
+        return it->entry = it->entry->next_in_bucket;
+    }
+    it->bucket++;
+    return CGS_MAP_INTERNAL(seek)(m, it);
+#else
+    return it->entry = it->entry->next != &m->root ? it->entry->next : NULL;
+#endif
+}
+
+#ifndef cgs_map_pooled
+/** @private Frees the entries kept by reset(). */
+static inline void CGS_MAP_INTERNAL(free_list_release)(cgs_map_name *m) {
+    CGS_MAP(entry) *node = m->free_list, *next;
+    while (node != NULL) {
+#ifdef cgs_map_compact
+        next = node->next_in_bucket;
+#else
+        next = node->next;
+#endif
+        cgs_map_free(m->alloc_ctx, node, sizeof(CGS_MAP(entry)));
+        node = next;
+    }
+    m->free_list = NULL;
+}
+#endif
+
+/**
+ * @brief Removes all entries from the map, but keeps all of its memory for reuse.
+ * The bucket array keeps its size, and is emptied with a single memset. The entries are kept for
+ * later insertions instead of being freed, so refilling a map to its previous size does not allocate.
+ * @param m The map to use.
+ */
+static inline void CGS_MAP(reset)(cgs_map_name *m) {
+#if defined(cgs_map_pooled)
+    CGS_MAP_INTERNAL(pool_reset)(&m->pool);
+#elif defined(cgs_map_compact)
+    for (size_t i = 0; i < m->vec.size; i++) {
+        CGS_MAP(entry) *node = m->vec.array[i], *next;
+        while (node != NULL) {
+            next = node->next_in_bucket;
+            node->next_in_bucket = m->free_list;
+            m->free_list = node;
+            node = next;
+        }
+    }
+#else
+    /* the list of all entries becomes the free list as a whole */
+    if (m->root.next != &m->root) {
+        m->root.prev->next = m->free_list;
+        m->free_list = m->root.next;
+    }
+#endif
+    memset(m->vec.array, 0, m->vec.size * sizeof(CGS_MAP(entry) *));
+#ifndef cgs_map_compact
+    m->root.next = m->root.prev = &m->root;
+#endif
+
+    m->size = 0;
+}
+
 /**
  * @brief Removes all entries from the map.
+ * The bucket array keeps its size. Unlike reset(), the entries are freed, except in a pooled map.
  * @param m The map to use.
  */
 static inline void CGS_MAP(clear)(cgs_map_name *m) {
+#if defined(cgs_map_pooled)
+    CGS_MAP_INTERNAL(pool_reset)(&m->pool);
+#elif defined(cgs_map_compact)
+    for (size_t i = 0; i < m->vec.size; i++) {
+        CGS_MAP(entry) *node = m->vec.array[i], *next;
+        while (node != NULL) {
+            next = node->next_in_bucket;
+            cgs_map_free(m->alloc_ctx, node, sizeof(CGS_MAP(entry)));
+            node = next;
+        }
+    }
+#else
     CGS_MAP(entry) *node = m->root.next, *next;
     while (node != &m->root) {
         next = node->next;
-        free(node);
+        cgs_map_free(m->alloc_ctx, node, sizeof(CGS_MAP(entry)));
         node = next;
     }
+#endif
+#ifndef cgs_map_pooled
+    CGS_MAP_INTERNAL(free_list_release)(m);
+#endif
+    memset(m->vec.array, 0, m->vec.size * sizeof(CGS_MAP(entry) *));
+#ifndef cgs_map_compact
+    m->root.next = m->root.prev = &m->root;
+#endif
 
     m->size = 0;
 }
 
+/**
+ * @brief Merges buckets until the load factor reaches cgs_map_load_factor, and releases unused memory.
+ * The bucket array is shrunk to its size, and entries kept by reset() are freed.
+ * The chunks of a pooled map are kept until the map is cleared and destroyed.
+ * @param m The map to use.
+ */
+static inline void CGS_MAP(shrink_to_fit)(cgs_map_name *m) {
+    size_t buckets = m->size * 100 / cgs_map_load_factor;
+    while (m->vec.size > buckets && m->vec.size > cgs_map_initial_capacity) {
+        CGS_MAP_INTERNAL(merge)(m);
+    }
+    CGS_MAP_INTERNAL(vec_shrink_to_fit)(&m->vec);
+#ifndef cgs_map_pooled
+    CGS_MAP_INTERNAL(free_list_release)(m);
+#endif
+}
+
+/**
+ * @brief Frees the data structures of a map initialized with init(), but not the map itself.
+ * The map must be initialized again before it is used.
+ * @param m The map to destroy.
+ */
+static inline void CGS_MAP(destroy)(cgs_map_name *m) {
+#ifdef cgs_map_pooled
+    CGS_MAP_INTERNAL(pool_destroy)(&m->pool);
+#else
+    CGS_MAP(clear)(m);
+#endif
+    CGS_MAP_INTERNAL(vec_destroy)(&m->vec);
+}
+
 /**
  * @brief Frees the map and all of its data structures.
  * @param m The map to free.
  */
 static inline void CGS_MAP(free)(cgs_map_name *m) {
-    CGS_MAP(clear)(m);
-    CGS_MAP_INTERNAL(vec_free)(m->vec);
-    free(m);
+    CGS_MAP(destroy)(m);
+    cgs_map_free(m->alloc_ctx, m, sizeof(cgs_map_name));
 }
 
 #undef cgs_map_key
@@ -361,4 +713,11 @@ static inline void CGS_MAP(free)(cgs_map_name *m) {
 #undef cgs_map_default_value
 #undef cgs_map_initial_capacity
 #undef cgs_map_load_factor
+#undef cgs_map_min_load_factor
+#undef cgs_map_pooled
+#undef cgs_map_pool_chunk_size
+#undef cgs_map_compact
+#undef cgs_map_malloc
+#undef cgs_map_realloc
+#undef cgs_map_free
 #endif /* include guard */
@@ -0,0 +1,213 @@
+/**
+ * @file cgs_pool.h
+ * @brief A pool allocator for objects of a single type.
+ *
+ * Objects are carved out of large chunks, and released objects are recycled through a free list.
+ * Releasing every object at once with reset() or destroy() only touches the chunks, not the objects.
+ *
+ * Define the following macros before including the header.
+ * - cgs_pool_name: Required. The name of the generated pool type. (e.g. `my_pool`)
+ * - cgs_pool_type: Required. The type of the objects. (e.g. `struct node`)
+ * - cgs_pool_chunk_size: Optional. The number of objects in a chunk. (Default: 256)
+ * - cgs_pool_malloc(ctx, size), cgs_pool_free(ctx, ptr, size): Optional. Replace the global allocator hooks
+ *   of cgs_common.h for this pool.
+ *
+ * After the header is included, define the macro `cgs_<cgs_pool_name>` to 1.
+ * This is to prevent clashes from multiple includes.
+ *
+ * For example, the following code generates the type `node_pool` that allocates `struct node` objects.
+ * ```
+ * #define cgs_pool_type struct node
+ * #define cgs_pool_name node_pool
+ * #include "cgs_pool.h"
+ * #define cgs_node_pool 1
+ * ```
+ */
+
+#include "cgs_common.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+
+/* Common macros (include only once) */
+#ifndef CGS_POOL_H
+#define CGS_POOL_H
+
+#define CGS_POOL(name) CGS_CAT(cgs_pool_name, name)
+#define CGS_POOL_INTERNAL(name) CGS_CAT_INTERNAL(cgs_pool_name, name)
+
+#endif
+
+/* semi include guard */
+#if !CGS_CAT(cgs, cgs_pool_name)
+
+typedef cgs_pool_type CGS_POOL(type);
+
+#ifndef cgs_pool_chunk_size
+#define cgs_pool_chunk_size 256
+#endif
+
+#ifndef cgs_pool_malloc
+#define cgs_pool_malloc CGS_MALLOC
+#endif
+#ifndef cgs_pool_free
+#define cgs_pool_free CGS_FREE
+#endif
+
+/** A slot of a chunk, which either holds an object or links to the next free slot. */
+typedef union CGS_POOL(slot) {
+    cgs_pool_type dat;
+    union CGS_POOL(slot) *next_free;
+} CGS_POOL(slot);
+
+/** A contiguous block of slots. Slots past `used` have never been handed out. */
+typedef struct CGS_POOL(chunk) {
+    struct CGS_POOL(chunk) *next;
+    size_t used, capacity;
+    CGS_POOL(slot) slots[];
+} CGS_POOL(chunk);
+
+/*
+ * The chunks form a singly linked list. Objects are bumped out of `current`,
+ * and every chunk after `current` is unused.
+ */
+typedef struct cgs_pool_name {
+    CGS_POOL(chunk) *chunks, *current;
+    CGS_POOL(slot) *free_list;
+    void *alloc_ctx;
+} cgs_pool_name;
+
+/**
+ * @brief Initialize a pool in place.
+ * The pool does not allocate any memory until the first object is requested.
+ * @param p The pool to initialize.
+ * @param ctx The context pointer passed to the allocator hooks.
+ */
+static inline void CGS_POOL(init)(cgs_pool_name *p, void *ctx) {
+    p->chunks = p->current = NULL;
+    p->free_list = NULL;
+    p->alloc_ctx = ctx;
+}
+
+/**
+ * @brief Allocate and initialize a new pool that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized pool.
+ */
+static inline cgs_pool_name *CGS_POOL(new_with_ctx)(void *ctx) {
+    cgs_pool_name *p = cgs_pool_malloc(ctx, sizeof(cgs_pool_name));
+    CGS_POOL(init)(p, ctx);
+    return p;
+}
+
+/**
+ * @brief Allocate and initialize a new pool.
+ * @return A newly allocated and initialized pool.
+ */
+static inline cgs_pool_name *CGS_POOL(new)() {
+    return CGS_POOL(new_with_ctx)(NULL);
+}
+
+/** @private Moves to the next chunk, allocating one with room for at least n objects if required. */
+static inline void CGS_POOL_INTERNAL(advance)(cgs_pool_name *p, size_t n) {
+    CGS_POOL(chunk) *next = p->current != NULL ? p->current->next : p->chunks;
+    if (next == NULL || next->capacity < n) {
+        size_t capacity = n > (cgs_pool_chunk_size) ? n : (cgs_pool_chunk_size);
+        CGS_POOL(chunk) *chunk = cgs_pool_malloc(p->alloc_ctx, sizeof(CGS_POOL(chunk)) + capacity * sizeof(CGS_POOL(slot)));
+        chunk->used = 0;
+        chunk->capacity = capacity;
+        chunk->next = next;
+        if (p->current != NULL) {
+            p->current->next = chunk;
+        } else {
+            p->chunks = chunk;
+        }
+        next = chunk;
+    }
+    p->current = next;
+}
+
+/**
+ * @brief Ensures that the next n objects can be allocated from a single chunk.
+ * Objects allocated right after this call are contiguous, unless released objects are recycled.
+ * @param p The pool to use.
+ * @param n The number of objects to reserve.
+ */
+static inline void CGS_POOL(reserve)(cgs_pool_name *p, size_t n) {
+    if (p->current == NULL || p->current->capacity - p->current->used < n) {
+        CGS_POOL_INTERNAL(advance)(p, n);
+    }
+}
+
+/**
+ * @brief Allocate an object from the pool.
+ * Released objects are reused first. The object is not initialized.
+ * @param p The pool to use.
+ * @return A pointer to the allocated object.
+ */
+static inline cgs_pool_type *CGS_POOL(alloc)(cgs_pool_name *p) {
+    CGS_POOL(slot) *slot = p->free_list;
+    if (slot != NULL) {
+        p->free_list = slot->next_free;
+        return &slot->dat;
+    }
+    CGS_POOL(reserve)(p, 1);
+    return &p->current->slots[p->current->used++].dat;
+}
+
+/**
+ * @brief Return an object to the pool, so that it may be reused by later allocations.
+ * @param p The pool to use.
+ * @param e The object to release. It must have been allocated from the pool p.
+ */
+static inline void CGS_POOL(release)(cgs_pool_name *p, cgs_pool_type *e) {
+    CGS_POOL(slot) *slot = (CGS_POOL(slot) *) e;
+    slot->next_free = p->free_list;
+    p->free_list = slot;
+}
+
+/**
+ * @brief Release all objects of the pool at once.
+ * The chunks are kept for later allocations.
+ * @param p The pool to reset.
+ */
+static inline void CGS_POOL(reset)(cgs_pool_name *p) {
+    for (CGS_POOL(chunk) *chunk = p->chunks; chunk != NULL; chunk = chunk->next) {
+        chunk->used = 0;
+    }
+    p->current = NULL;
+    p->free_list = NULL;
+}
+
+/**
+ * @brief Release all objects and chunks of a pool initialized with init().
+ * The pool is left empty, and may still be used afterwards.
+ * @param p The pool to destroy.
+ */
+static inline void CGS_POOL(destroy)(cgs_pool_name *p) {
+    CGS_POOL(chunk) *chunk = p->chunks, *next;
+    while (chunk != NULL) {
+        next = chunk->next;
+        cgs_pool_free(p->alloc_ctx, chunk, sizeof(CGS_POOL(chunk)) + chunk->capacity * sizeof(CGS_POOL(slot)));
+        chunk = next;
+    }
+    p->chunks = p->current = NULL;
+    p->free_list = NULL;
+}
+
+/**
+ * @brief Frees the pool and all of its objects.
+ * @param p The pool to free.
+ */
+static inline void CGS_POOL(free)(cgs_pool_name *p) {
+    CGS_POOL(destroy)(p);
+    cgs_pool_free(p->alloc_ctx, p, sizeof(cgs_pool_name));
+}
+
+#undef cgs_pool_type
+#undef cgs_pool_name
+#undef cgs_pool_chunk_size
+#undef cgs_pool_malloc
+#undef cgs_pool_free
+#endif /* semi include guard */
@@ -0,0 +1,372 @@
+/**
+ * @file cgs_ring.h
+ * @brief A bounded first-in first-out queue, backed with a circular array.
+ *
+ * The capacity is fixed when the ring is created, and rounded up to a power of two.
+ * Pushing to a full ring or popping from an empty ring fails instead of blocking.
+ *
+ * Define the following macros before including the header.
+ * - cgs_ring_name: Required. The name of the generated ring type. (e.g. `my_ring`)
+ * - cgs_ring_type: Required. The type of the elements. (e.g. `int`, `struct packet *`)
+ *
+ * By default, the ring may only be used by a single thread. Define one of the following macros to share it.
+ * - cgs_ring_spsc: One producer thread and one consumer thread may use the ring concurrently, without locks.
+ * - cgs_ring_mpmc: Any number of producer and consumer threads may use the ring concurrently, without locks.
+ *   Each slot carries a sequence number that tells whether it is ready to be written or read.
+ *
+ * The following macros are optional, and replace the global allocator hooks of cgs_common.h for this ring.
+ * - cgs_ring_malloc(ctx, size): Allocates memory.
+ * - cgs_ring_free(ctx, ptr, size): Frees memory allocated with cgs_ring_malloc.
+ *
+ * After the header is included, define the macro `cgs_<cgs_ring_name>` to 1.
+ * This is to prevent clashes from multiple includes.
+ *
+ * For example, the following code generates the type `pring`, which hands `struct packet *` from one thread to another.
+ * ```
+ * #define cgs_ring_type struct packet *
+ * #define cgs_ring_name pring
+ * #define cgs_ring_spsc
+ * #include "cgs_ring.h"
+ * #define cgs_pring 1
+ * ```
+ */
+
+#include "cgs_common.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* Common macros (include only once) */
+#ifndef CGS_RING_H
+#define CGS_RING_H
+
+#define CGS_RING(name) CGS_CAT(cgs_ring_name, name)
+#define CGS_RING_INTERNAL(name) CGS_CAT_INTERNAL(cgs_ring_name, name)
+
+#endif
+
+/* semi include guard */
+#if !CGS_CAT(cgs, cgs_ring_name)
+
+#if defined(cgs_ring_spsc) && defined(cgs_ring_mpmc)
+#error "cgs_ring_spsc and cgs_ring_mpmc cannot be defined at the same time"
+#endif
+
+typedef cgs_ring_type CGS_RING(type);
+
+#ifndef cgs_ring_malloc
+#define cgs_ring_malloc CGS_MALLOC
+#endif
+#ifndef cgs_ring_free
+#define cgs_ring_free CGS_FREE
+#endif
+
+#ifdef cgs_ring_mpmc
+/** A slot of the ring. `seq` equals the position of the slot when it is free, and the position + 1 when it is full. */
+typedef struct CGS_RING(slot) {
+    size_t seq;
+    cgs_ring_type dat;
+} CGS_RING(slot);
+#else
+typedef cgs_ring_type CGS_RING(slot);
+#endif
+
+/*
+ * `head` and `tail` count every pop and push, and are only masked when indexing the slots.
+ * The consumer and producer sides are kept on separate cache lines, so that they do not slow down each other.
+ */
+typedef struct cgs_ring_name {
+    CGS_RING(slot) *slots;
+    size_t mask;
+    void *alloc_ctx;
+    void *raw; /* the allocation that holds this ring, which may not be aligned */
+
+    CGS_ALIGNED(CGS_CACHE_LINE) size_t head;
+    size_t tail_cache; /* the consumer's last view of tail, so that it is not reloaded on every pop */
+
+    CGS_ALIGNED(CGS_CACHE_LINE) size_t tail;
+    size_t head_cache; /* the producer's last view of head, so that it is not reloaded on every push */
+} cgs_ring_name;
+
+/**
+ * @brief Allocate and initialize a new ring that uses the given allocator context.
+ * @param capacity The maximum number of elements. Rounded up to a power of two.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized ring.
+ */
+static inline cgs_ring_name *CGS_RING(new_with_ctx)(size_t capacity, void *ctx) {
+    void *raw = cgs_ring_malloc(ctx, sizeof(cgs_ring_name) + CGS_CACHE_LINE - 1);
+    cgs_ring_name *r = (cgs_ring_name *) (((uintptr_t) raw + CGS_CACHE_LINE - 1) & ~(uintptr_t) (CGS_CACHE_LINE - 1));
+    size_t size = 1;
+    while (size < capacity) {
+        size *= 2;
+    }
+    r->slots = cgs_ring_malloc(ctx, sizeof(CGS_RING(slot)) * size);
+    r->mask = size - 1;
+    r->alloc_ctx = ctx;
+    r->raw = raw;
+    r->head = r->tail_cache = 0;
+    r->tail = r->head_cache = 0;
+#ifdef cgs_ring_mpmc
+    for (size_t i = 0; i < size; i++) {
+        r->slots[i].seq = i;
+    }
+#endif
+    return r;
+}
+
+/**
+ * @brief Allocate and initialize a new ring.
+ * @param capacity The maximum number of elements. Rounded up to a power of two.
+ * @return A newly allocated and initialized ring.
+ */
+static inline cgs_ring_name *CGS_RING(new)(size_t capacity) {
+    return CGS_RING(new_with_ctx)(capacity, NULL);
+}
+
+/** @private Loads an index written by the other side of the ring. */
+static inline size_t CGS_RING_INTERNAL(load)(size_t *p) {
+#if defined(cgs_ring_spsc) || defined(cgs_ring_mpmc)
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+#else
+    return *p;
+#endif
+}
+
+/** @private Publishes an index to the other side of the ring. */
+static inline void CGS_RING_INTERNAL(store)(size_t *p, size_t value) {
+#if defined(cgs_ring_spsc) || defined(cgs_ring_mpmc)
+    __atomic_store_n(p, value, __ATOMIC_RELEASE);
+#else
+    *p = value;
+#endif
+}
+
+/**
+ * @brief Get the maximum number of elements in the ring.
+ * @param r The ring to query.
+ * @return The capacity of the ring.
+ */
+static inline size_t CGS_RING(capacity)(cgs_ring_name *r) {
+    return r->mask + 1;
+}
+
+/**
+ * @brief Get the number of elements in the ring.
+ * If other threads use the ring, the result may be outdated as soon as it is returned.
+ * @param r The ring to query.
+ * @return The number of elements in the ring.
+ */
+static inline size_t CGS_RING(size)(cgs_ring_name *r) {
+    size_t head = CGS_RING_INTERNAL(load)(&r->head);
+    size_t tail = CGS_RING_INTERNAL(load)(&r->tail);
+    /* head is loaded first, so it never passes tail, but tail may have run a lap ahead of it */
+    return tail - head > r->mask + 1 ? r->mask + 1 : tail - head;
+}
+
+/**
+ * @brief Check whether the ring is empty.
+ * If other threads use the ring, the result may be outdated as soon as it is returned.
+ * @param r The ring to query.
+ * @return Whether the ring is empty.
+ */
+static inline bool CGS_RING(empty)(cgs_ring_name *r) {
+    return CGS_RING(size)(r) == 0;
+}
+
+#ifdef cgs_ring_mpmc
+
+/**
+ * @brief Push up to n elements to the back of the ring.
+ * The elements are pushed in order, and pushed elements are contiguous in the ring.
+ * @param r The ring to use.
+ * @param arr The elements to push.
+ * @param n The number of elements to push.
+ * @return The number of elements that were pushed, which is less than n if the ring became full.
+ */
+static inline size_t CGS_RING(push_n)(cgs_ring_name *r, const CGS_RING(type) *arr, size_t n) {
+    size_t pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+    size_t count;
+    if (n == 0) {
+        return 0;
+    }
+    for (;;) {
+        /* count the free slots from pos, then claim them all at once */
+        for (count = 0; count < n; count++) {
+            if (__atomic_load_n(&r->slots[(pos + count) & r->mask].seq, __ATOMIC_ACQUIRE) != pos + count) {
+                break;
+            }
+        }
+        if (count == 0) {
+            size_t seq = __atomic_load_n(&r->slots[pos & r->mask].seq, __ATOMIC_ACQUIRE);
+            if ((intptr_t) (seq - pos) < 0) {
+                return 0; /* the slot still holds an element from the previous lap: full */
+            }
+            pos = __atomic_load_n(&r->tail, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&r->tail, &pos, pos + count, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        CGS_RING(slot) *slot = &r->slots[(pos + i) & r->mask];
+        slot->dat = arr[i];
+        __atomic_store_n(&slot->seq, pos + i + 1, __ATOMIC_RELEASE);
+    }
+    return count;
+}
+
+/**
+ * @brief Pop up to n elements from the front of the ring.
+ * @param r The ring to use.
+ * @param out The array to store the popped elements in. Must have room for n elements.
+ * @param n The maximum number of elements to pop.
+ * @return The number of elements that were popped, which is less than n if the ring became empty.
+ */
+static inline size_t CGS_RING(pop_n)(cgs_ring_name *r, CGS_RING(type) *out, size_t n) {
+    size_t pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+    size_t count;
+    if (n == 0) {
+        return 0;
+    }
+    for (;;) {
+        for (count = 0; count < n; count++) {
+            if (__atomic_load_n(&r->slots[(pos + count) & r->mask].seq, __ATOMIC_ACQUIRE) != pos + count + 1) {
+                break;
+            }
+        }
+        if (count == 0) {
+            size_t seq = __atomic_load_n(&r->slots[pos & r->mask].seq, __ATOMIC_ACQUIRE);
+            if ((intptr_t) (seq - (pos + 1)) < 0) {
+                return 0; /* the slot has not been written in this lap: empty */
+            }
+            pos = __atomic_load_n(&r->head, __ATOMIC_RELAXED);
+            continue;
+        }
+        if (__atomic_compare_exchange_n(&r->head, &pos, pos + count, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+            break;
+        }
+    }
+    for (size_t i = 0; i < count; i++) {
+        CGS_RING(slot) *slot = &r->slots[(pos + i) & r->mask];
+        out[i] = slot->dat;
+        /* free the slot for the position one lap later */
+        __atomic_store_n(&slot->seq, pos + i + r->mask + 1, __ATOMIC_RELEASE);
+    }
+    return count;
+}
+
+#else
+
+/** @private Copies n elements to the slots, starting from the position pos. */
+static inline void CGS_RING_INTERNAL(copy_in)(cgs_ring_name *r, size_t pos, const CGS_RING(type) *arr, size_t n) {
+    size_t start = pos & r->mask;
+    size_t first = r->mask + 1 - start;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(&r->slots[start], arr, first * sizeof(CGS_RING(slot)));
+    memcpy(r->slots, arr + first, (n - first) * sizeof(CGS_RING(slot)));
+}
+
+/** @private Copies n elements from the slots, starting from the position pos. */
+static inline void CGS_RING_INTERNAL(copy_out)(cgs_ring_name *r, size_t pos, CGS_RING(type) *out, size_t n) {
+    size_t start = pos & r->mask;
+    size_t first = r->mask + 1 - start;
+    if (first > n) {
+        first = n;
+    }
+    memcpy(out, &r->slots[start], first * sizeof(CGS_RING(slot)));
+    memcpy(out + first, r->slots, (n - first) * sizeof(CGS_RING(slot)));
+}
+
+/**
+ * @brief Push up to n elements to the back of the ring.
+ * The elements are pushed in order, and become visible to the consumer at once.
+ * @param r The ring to use.
+ * @param arr The elements to push.
+ * @param n The number of elements to push.
+ * @return The number of elements that were pushed, which is less than n if the ring became full.
+ */
+static inline size_t CGS_RING(push_n)(cgs_ring_name *r, const CGS_RING(type) *arr, size_t n) {
+    size_t tail = r->tail; /* only the producer writes tail */
+    size_t room = r->mask + 1 - (tail - r->head_cache);
+    if (room < n) {
+        r->head_cache = CGS_RING_INTERNAL(load)(&r->head);
+        room = r->mask + 1 - (tail - r->head_cache);
+        if (room < n) {
+            n = room;
+        }
+    }
+    if (n > 0) {
+        CGS_RING_INTERNAL(copy_in)(r, tail, arr, n);
+        CGS_RING_INTERNAL(store)(&r->tail, tail + n);
+    }
+    return n;
+}
+
+/**
+ * @brief Pop up to n elements from the front of the ring.
+ * @param r The ring to use.
+ * @param out The array to store the popped elements in. Must have room for n elements.
+ * @param n The maximum number of elements to pop.
+ * @return The number of elements that were popped, which is less than n if the ring became empty.
+ */
+static inline size_t CGS_RING(pop_n)(cgs_ring_name *r, CGS_RING(type) *out, size_t n) {
+    size_t head = r->head; /* only the consumer writes head */
+    size_t count = r->tail_cache - head;
+    if (count < n) {
+        r->tail_cache = CGS_RING_INTERNAL(load)(&r->tail);
+        count = r->tail_cache - head;
+        if (count < n) {
+            n = count;
+        }
+    }
+    if (n > 0) {
+        CGS_RING_INTERNAL(copy_out)(r, head, out, n);
+        CGS_RING_INTERNAL(store)(&r->head, head + n);
+    }
+    return n;
+}
+
+#endif
+
+/**
+ * @brief Push an element to the back of the ring.
+ * @param r The ring to use.
+ * @param e The element to push.
+ * @return Whether the element was pushed. false if the ring is full.
+ */
+static inline bool CGS_RING(push)(cgs_ring_name *r, cgs_ring_type e) {
+    return CGS_RING(push_n)(r, &e, 1) == 1;
+}
+
+/**
+ * @brief Pop an element from the front of the ring.
+ * @param r The ring to use.
+ * @param out Where to store the popped element.
+ * @return Whether an element was popped. false if the ring is empty.
+ */
+static inline bool CGS_RING(pop)(cgs_ring_name *r, CGS_RING(type) *out) {
+    return CGS_RING(pop_n)(r, out, 1) == 1;
+}
+
+/**
+ * @brief Frees the ring and all of its data structures.
+ * No other thread may access the ring during or after this call.
+ * @param r The ring to free.
+ */
+static inline void CGS_RING(free)(cgs_ring_name *r) {
+    cgs_ring_free(r->alloc_ctx, r->slots, sizeof(CGS_RING(slot)) * (r->mask + 1));
+    cgs_ring_free(r->alloc_ctx, r->raw, sizeof(cgs_ring_name) + CGS_CACHE_LINE - 1);
+}
+
+#undef cgs_ring_type
+#undef cgs_ring_name
+#undef cgs_ring_spsc
+#undef cgs_ring_mpmc
+#undef cgs_ring_malloc
+#undef cgs_ring_free
+#endif /* include guard */
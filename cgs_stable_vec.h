@@ -0,0 +1,298 @@
+/**
+ * @file cgs_stable_vec.h
+ * @brief A variable-length vector whose elements never move, backed with power-of-two segments.
+ *
+ * Instead of reallocating and copying its array, the vector grows by allocating a new segment twice as large
+ * as the previous one. Pointers to elements stay valid until the elements are popped, and the worst case of
+ * push_back() is a single allocation. An index is mapped to its segment with a bit scan, in O(1).
+ * The elements of a segment are contiguous, and can be visited segment by segment with segment().
+ *
+ * Define the following macros before including the header.
+ * - cgs_svec_name: The name of the generated vector type. (e.g. `my_stable_vec`)
+ * - cgs_svec_type: The type of the elements. (e.g. `int`, `char *`)
+ *
+ * The following macros are optional.
+ * - cgs_svec_first_segment: The number of elements in the first segment. Must be a power of two. (Default: 16)
+ * - cgs_svec_malloc(ctx, size), cgs_svec_free(ctx, ptr, size): Replace the global allocator hooks
+ *   of cgs_common.h for this vector.
+ *
+ * After the header is included, define the macro `cgs_<cgs_svec_name>` to 1.
+ * This is to prevent clashes from multiple includes.
+ *
+ * For example, the following code generates the type `dsvec` as a stable vector of doubles.
+ * ```
+ * #define cgs_svec_type double
+ * #define cgs_svec_name dsvec
+ * #include "cgs_stable_vec.h"
+ * #define cgs_dsvec 1
+ * ```
+ */
+
+#include "cgs_common.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+/* Common macros (include only once) */
+#ifndef CGS_STABLE_VEC_H
+#define CGS_STABLE_VEC_H
+
+/** The maximum number of segments, which is enough to address every index of a size_t. */
+#define CGS_STABLE_VEC_MAX_SEGMENTS (sizeof(size_t) * 8)
+
+#define CGS_SVEC(name) CGS_CAT(cgs_svec_name, name)
+#define CGS_SVEC_INTERNAL(name) CGS_CAT_INTERNAL(cgs_svec_name, name)
+
+#endif
+
+/* semi include guard */
+#if !CGS_CAT(cgs, cgs_svec_name)
+
+typedef cgs_svec_type CGS_SVEC(type);
+
+#ifndef cgs_svec_first_segment
+#define cgs_svec_first_segment 16
+#endif
+
+#ifndef cgs_svec_malloc
+#define cgs_svec_malloc CGS_MALLOC
+#endif
+#ifndef cgs_svec_free
+#define cgs_svec_free CGS_FREE
+#endif
+
+/*
+ * Segment k holds (cgs_svec_first_segment << k) elements, starting at index cgs_svec_first_segment * (2^k - 1).
+ * Only the first `segment_count` segments are allocated.
+ */
+typedef struct cgs_svec_name {
+    size_t size, capacity;
+    size_t segment_count;
+    cgs_svec_type *segments[CGS_STABLE_VEC_MAX_SEGMENTS];
+    void *alloc_ctx;
+} cgs_svec_name;
+
+/**
+ * @brief Initialize a vector in place, e.g. one embedded in another struct or on the stack.
+ * The vector does not allocate any memory until the first element is pushed.
+ * @param v The vector to initialize.
+ * @param ctx The context pointer passed to the allocator hooks.
+ */
+static inline void CGS_SVEC(init)(cgs_svec_name *v, void *ctx) {
+    v->size = 0;
+    v->capacity = 0;
+    v->segment_count = 0;
+    v->alloc_ctx = ctx;
+}
+
+/**
+ * @brief Allocate and initialize a new vector that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized vector.
+ */
+static inline cgs_svec_name *CGS_SVEC(new_with_ctx)(void *ctx) {
+    cgs_svec_name *v = cgs_svec_malloc(ctx, sizeof(cgs_svec_name));
+    CGS_SVEC(init)(v, ctx);
+    return v;
+}
+
+/**
+ * @brief Allocate and initialize a new vector.
+ * @return A newly allocated and initialized vector.
+ */
+static inline cgs_svec_name *CGS_SVEC(new)() {
+    return CGS_SVEC(new_with_ctx)(NULL);
+}
+
+/** @private Returns the number of elements in a segment. */
+static inline size_t CGS_SVEC_INTERNAL(segment_size)(size_t k) {
+    return (size_t) (cgs_svec_first_segment) << k;
+}
+
+/** @private Returns the segment of an index, and sets offset to the position of the index in the segment. */
+static inline size_t CGS_SVEC_INTERNAL(locate)(size_t index, size_t *offset) {
+    size_t k = 63 - cgs_clz64((uint64_t) (index / (cgs_svec_first_segment) + 1));
+    *offset = index - (cgs_svec_first_segment) * (((size_t) 1 << k) - 1);
+    return k;
+}
+
+/**
+ * @brief Get a pointer to the element at a given index in the vector.
+ * The pointer stays valid until the element is popped, even if the vector grows.
+ * @param v The vector to query.
+ * @param index The index to the desired element.
+ * @return A pointer to the element at the given index.
+ */
+static inline cgs_svec_type *CGS_SVEC(ptr)(cgs_svec_name *v, size_t index) {
+    size_t offset, k;
+    assert(index < v->size);
+    k = CGS_SVEC_INTERNAL(locate)(index, &offset);
+    return &v->segments[k][offset];
+}
+
+/**
+ * @brief Get the element at a given index in the vector.
+ * @param v The vector to query.
+ * @param index The index to the desired element.
+ * @return The element at the given index.
+ */
+static inline cgs_svec_type CGS_SVEC(at)(cgs_svec_name *v, size_t index) {
+    return *CGS_SVEC(ptr)(v, index);
+}
+
+/**
+ * @brief Set the element at a given index in the vector.
+ * @param v The vector to query.
+ * @param index The index to the desired element.
+ * @param e The element to set to.
+ */
+static inline void CGS_SVEC(set)(cgs_svec_name *v, size_t index, cgs_svec_type e) {
+    *CGS_SVEC(ptr)(v, index) = e;
+}
+
+/**
+ * @brief Check whether the vector is empty.
+ * @param v The vector to query.
+ * @return Whether the vector is empty.
+ */
+static inline bool CGS_SVEC(empty)(cgs_svec_name *v) {
+    return v->size == 0;
+}
+
+/**
+ * @brief Get the contiguous run of elements that starts at a given index.
+ * Calling this with index 0, then with the index right after the returned run, visits the whole vector
+ * one segment at a time.
+ * @param v The vector to query.
+ * @param index The index of the first element of the run.
+ * @param n Set to the number of elements in the run.
+ * @return A pointer to the first element of the run.
+ */
+static inline cgs_svec_type *CGS_SVEC(segment)(cgs_svec_name *v, size_t index, size_t *n) {
+    size_t offset, k, remaining = v->size - index;
+    assert(index < v->size);
+    k = CGS_SVEC_INTERNAL(locate)(index, &offset);
+    *n = CGS_SVEC_INTERNAL(segment_size)(k) - offset;
+    *n = *n < remaining ? *n : remaining;
+    return &v->segments[k][offset];
+}
+
+/**
+ * @brief Reserve capacity in the vector.
+ * Allocates segments until the vector's capacity is at least as large as the given size.
+ * @param v The vector to use.
+ * @param s The desired capacity.
+ */
+static inline void CGS_SVEC(reserve)(cgs_svec_name *v, size_t s) {
+    while (v->capacity < s) {
+        size_t n = CGS_SVEC_INTERNAL(segment_size)(v->segment_count);
+        assert(v->segment_count < CGS_STABLE_VEC_MAX_SEGMENTS);
+        v->segments[v->segment_count++] = cgs_svec_malloc(v->alloc_ctx, n * sizeof(cgs_svec_type));
+        v->capacity += n;
+    }
+}
+
+/**
+ * @brief Push an element to the end of the vector.
+ * The existing elements are never moved.
+ * @param v The vector to use.
+ * @param e The element to push.
+ */
+static inline void CGS_SVEC(push_back)(cgs_svec_name *v, cgs_svec_type e) {
+    CGS_SVEC(reserve)(v, v->size + 1);
+    v->size++;
+    *CGS_SVEC(ptr)(v, v->size - 1) = e;
+}
+
+/**
+ * @brief Push n elements to the end of the vector, copying them one segment at a time.
+ * @param v The vector to use.
+ * @param arr The elements to push.
+ * @param n The number of elements to push.
+ */
+static inline void CGS_SVEC(append_array)(cgs_svec_name *v, const CGS_SVEC(type) *arr, size_t n) {
+    size_t index = v->size, count;
+    CGS_SVEC(reserve)(v, v->size + n);
+    v->size += n;
+    while (n > 0) {
+        cgs_svec_type *dst = CGS_SVEC(segment)(v, index, &count);
+        memcpy(dst, arr, count * sizeof(cgs_svec_type));
+        arr += count;
+        index += count;
+        n -= count;
+    }
+}
+
+/**
+ * @brief Pop an element from the end of the vector and return it.
+ * The segments are kept for later pushes.
+ * @param v The vector to use.
+ * @return The element that was popped.
+ */
+static inline cgs_svec_type CGS_SVEC(pop_back)(cgs_svec_name *v) {
+    cgs_svec_type res = CGS_SVEC(at)(v, v->size - 1);
+    v->size--;
+    return res;
+}
+
+/**
+ * @brief Get the last element of the vector.
+ * @param v The vector to query.
+ * @return The last element.
+ */
+static inline cgs_svec_type CGS_SVEC(back)(cgs_svec_name *v) {
+    return CGS_SVEC(at)(v, v->size - 1);
+}
+
+/**
+ * @brief Remove all elements from the vector.
+ * The segments are kept for later pushes.
+ * @param v The vector to use.
+ */
+static inline void CGS_SVEC(clear)(cgs_svec_name *v) {
+    v->size = 0;
+}
+
+/**
+ * @brief Free the segments that do not hold any elements.
+ * @param v The vector to use.
+ */
+static inline void CGS_SVEC(shrink_to_fit)(cgs_svec_name *v) {
+    while (v->segment_count > 0) {
+        size_t n = CGS_SVEC_INTERNAL(segment_size)(v->segment_count - 1);
+        if (v->capacity - n < v->size) {
+            break;
+        }
+        v->segment_count--;
+        cgs_svec_free(v->alloc_ctx, v->segments[v->segment_count], n * sizeof(cgs_svec_type));
+        v->capacity -= n;
+    }
+}
+
+/**
+ * @brief Frees the data structures of a vector initialized with init(), but not the vector itself.
+ * The vector is left empty, and may still be used afterwards.
+ * @param v The vector to destroy.
+ */
+static inline void CGS_SVEC(destroy)(cgs_svec_name *v) {
+    CGS_SVEC(clear)(v);
+    CGS_SVEC(shrink_to_fit)(v);
+}
+
+/**
+ * @brief Frees the vector and all of its data structures.
+ * @param v The vector to free.
+ */
+static inline void CGS_SVEC(free)(cgs_svec_name *v) {
+    CGS_SVEC(destroy)(v);
+    cgs_svec_free(v->alloc_ctx, v, sizeof(cgs_svec_name));
+}
+
+#undef cgs_svec_type
+#undef cgs_svec_name
+#undef cgs_svec_first_segment
+#undef cgs_svec_malloc
+#undef cgs_svec_free
+#endif /* semi include guard */
@@ -0,0 +1,356 @@
+/**
+ * @file cgs_ulist.h
+ * @brief An unrolled linked list, where each node holds a small array of elements.
+ *
+ * Storing several elements per node amortizes the two link pointers and the allocation of a node,
+ * and lets iteration run through contiguous memory instead of chasing a pointer for every element.
+ * Pushing and popping at both ends and splicing whole lists take O(1) time.
+ *
+ * Define the following macros before including the header.
+ * - cgs_ulist_name: The name of the generated list type. (e.g. `my_ulist`)
+ * - cgs_ulist_type: The type of the elements. (e.g. `int`, `char *`)
+ *
+ * The following macros are optional.
+ * - cgs_ulist_node_capacity: The number of elements in a node.
+ *   (Default: as many as fit in a node of two cache lines, but at least 4)
+ * - cgs_ulist_malloc(ctx, size), cgs_ulist_free(ctx, ptr, size): Replace the global allocator hooks
+ *   of cgs_common.h for this list.
+ *
+ * After the header is included, define the macro `cgs_<cgs_ulist_name>` to 1.
+ * This is to prevent clashes from multiple includes.
+ *
+ * For example, the following code generates the type `iulist` as an unrolled list of ints.
+ * ```
+ * #define cgs_ulist_type int
+ * #define cgs_ulist_name iulist
+ * #include "cgs_ulist.h"
+ * #define cgs_iulist 1
+ * ```
+ */
+
+#include "cgs_common.h"
+#include <stdlib.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <assert.h>
+
+/* Common macros (include only once) */
+#ifndef CGS_ULIST_H
+#define CGS_ULIST_H
+/**
+ * @brief Generates a for-each loop.
+ *
+ * The parameters `n` and `e` are defined inside the macro, so they should not be defined outside.
+ * The list must not be modified inside the loop. `break` and `continue` work as in a plain loop.
+ *
+ * @param t The name of the list type. (e.g. `my_ulist`)
+ * @param l The list to iterate on.
+ * @param n The variable that holds the current node.
+ * @param e The variable that holds the current element.
+ */
+#define cgs_ulist_foreach(t, l, n, e) for (CGS_CAT(t, node) *n = CGS_CAT(t, front_node)(l); n; n = NULL) \
+                                          for (size_t n##__i = n->begin; n; n = n##__i == n->end ? n->next : NULL, n##__i = n ? n->begin : 0) \
+                                              for (CGS_CAT(t, type) e; n##__i < n->end && (e = n->dat[n##__i], 1); n##__i++)
+#define CGS_ULIST(name) CGS_CAT(cgs_ulist_name, name)
+#define CGS_ULIST_INTERNAL(name) CGS_CAT_INTERNAL(cgs_ulist_name, name)
+#endif
+
+/* semi include guard */
+#if !CGS_CAT(cgs, cgs_ulist_name)
+
+typedef cgs_ulist_type CGS_ULIST(type);
+
+#ifndef cgs_ulist_node_capacity
+#define CGS_ULIST_CAPACITY \
+    ((2 * CGS_CACHE_LINE - 2 * sizeof(void *) - 2 * sizeof(uint32_t)) / sizeof(cgs_ulist_type) > 4 ? \
+     (2 * CGS_CACHE_LINE - 2 * sizeof(void *) - 2 * sizeof(uint32_t)) / sizeof(cgs_ulist_type) : 4)
+#else
+#define CGS_ULIST_CAPACITY (cgs_ulist_node_capacity)
+#endif
+
+#ifndef cgs_ulist_malloc
+#define cgs_ulist_malloc CGS_MALLOC
+#endif
+#ifndef cgs_ulist_free
+#define cgs_ulist_free CGS_FREE
+#endif
+
+/** A node of the list. Its elements are dat[begin] to dat[end - 1], and a node in a list is never empty. */
+typedef struct CGS_ULIST(node) {
+    struct CGS_ULIST(node) *prev, *next;
+    uint32_t begin, end;
+    cgs_ulist_type dat[CGS_ULIST_CAPACITY];
+} CGS_ULIST(node);
+
+typedef struct {
+    size_t size;
+    CGS_ULIST(node) *head, *tail;
+    void *alloc_ctx;
+} cgs_ulist_name;
+
+/**
+ * @brief Initialize a list in place, e.g. one embedded in another struct or on the stack.
+ * The list does not allocate any memory until the first element is pushed.
+ * @param l The list to initialize.
+ * @param ctx The context pointer passed to the allocator hooks.
+ */
+static inline void CGS_ULIST(init)(cgs_ulist_name *l, void *ctx) {
+    l->size = 0;
+    l->head = l->tail = NULL;
+    l->alloc_ctx = ctx;
+}
+
+/**
+ * @brief Allocate and initialize a new list that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized list.
+ */
+static inline cgs_ulist_name *CGS_ULIST(new_with_ctx)(void *ctx) {
+    cgs_ulist_name *res = cgs_ulist_malloc(ctx, sizeof(cgs_ulist_name));
+    CGS_ULIST(init)(res, ctx);
+    return res;
+}
+
+/**
+ * @brief Allocate and initialize a new list.
+ * @return A newly allocated and initialized list.
+ */
+static inline cgs_ulist_name *CGS_ULIST(new)() {
+    return CGS_ULIST(new_with_ctx)(NULL);
+}
+
+/**
+ * @brief Check whether the list is empty.
+ * @param l The list to query.
+ * @return Whether the list is empty.
+ */
+static inline bool CGS_ULIST(empty)(cgs_ulist_name *l) {
+    return l->size == 0;
+}
+
+/**
+ * @brief Returns the first node of the list, or NULL if the list is empty.
+ * @param l The list to query.
+ * @return The first node of the list.
+ */
+static inline CGS_ULIST(node) *CGS_ULIST(front_node)(cgs_ulist_name *l) {
+    return l->head;
+}
+
+/**
+ * @brief Returns the last node of the list, or NULL if the list is empty.
+ * @param l The list to query.
+ * @return The last node of the list.
+ */
+static inline CGS_ULIST(node) *CGS_ULIST(back_node)(cgs_ulist_name *l) {
+    return l->tail;
+}
+
+/** @private Allocates an empty node whose elements start at the given index, and links it at an end. */
+static inline CGS_ULIST(node) *CGS_ULIST_INTERNAL(add_node)(cgs_ulist_name *l, bool back, uint32_t index) {
+    CGS_ULIST(node) *node = cgs_ulist_malloc(l->alloc_ctx, sizeof(CGS_ULIST(node)));
+    node->begin = node->end = index;
+    if (back) {
+        node->prev = l->tail;
+        node->next = NULL;
+        if (l->tail != NULL) {
+            l->tail->next = node;
+        } else {
+            l->head = node;
+        }
+        l->tail = node;
+    } else {
+        node->prev = NULL;
+        node->next = l->head;
+        if (l->head != NULL) {
+            l->head->prev = node;
+        } else {
+            l->tail = node;
+        }
+        l->head = node;
+    }
+    return node;
+}
+
+/** @private Unlinks and frees a node that became empty. */
+static inline void CGS_ULIST_INTERNAL(remove_node)(cgs_ulist_name *l, CGS_ULIST(node) *node) {
+    if (node->prev != NULL) {
+        node->prev->next = node->next;
+    } else {
+        l->head = node->next;
+    }
+    if (node->next != NULL) {
+        node->next->prev = node->prev;
+    } else {
+        l->tail = node->prev;
+    }
+    cgs_ulist_free(l->alloc_ctx, node, sizeof(CGS_ULIST(node)));
+}
+
+/**
+ * @brief Push an element at the back of the list.
+ * @param l The list to modify.
+ * @param e The element to push.
+ */
+static inline void CGS_ULIST(push_back)(cgs_ulist_name *l, cgs_ulist_type e) {
+    CGS_ULIST(node) *node = l->tail;
+    if (node == NULL || node->end == CGS_ULIST_CAPACITY) {
+        node = CGS_ULIST_INTERNAL(add_node)(l, true, 0);
+    }
+    node->dat[node->end++] = e;
+    l->size++;
+}
+
+/**
+ * @brief Push an element at the front of the list.
+ * @param l The list to modify.
+ * @param e The element to push.
+ */
+static inline void CGS_ULIST(push_front)(cgs_ulist_name *l, cgs_ulist_type e) {
+    CGS_ULIST(node) *node = l->head;
+    if (node == NULL || node->begin == 0) {
+        /* fill the new node from its end, so that further pushes to the front fit in it */
+        node = CGS_ULIST_INTERNAL(add_node)(l, false, CGS_ULIST_CAPACITY);
+    }
+    node->dat[--node->begin] = e;
+    l->size++;
+}
+
+/**
+ * @brief Push n elements at the back of the list, filling whole nodes at a time.
+ * @param l The list to modify.
+ * @param arr The elements to push.
+ * @param n The number of elements to push.
+ */
+static inline void CGS_ULIST(append_array)(cgs_ulist_name *l, const CGS_ULIST(type) *arr, size_t n) {
+    CGS_ULIST(node) *node = l->tail;
+    l->size += n;
+    while (n > 0) {
+        if (node == NULL || node->end == CGS_ULIST_CAPACITY) {
+            node = CGS_ULIST_INTERNAL(add_node)(l, true, 0);
+        }
+        size_t count = CGS_ULIST_CAPACITY - node->end < n ? CGS_ULIST_CAPACITY - node->end : n;
+        memcpy(&node->dat[node->end], arr, count * sizeof(cgs_ulist_type));
+        node->end += count;
+        arr += count;
+        n -= count;
+    }
+}
+
+/**
+ * @brief Returns the first element of the list.
+ * @param l The list to query.
+ * @return The first element of the list.
+ */
+static inline cgs_ulist_type CGS_ULIST(front)(cgs_ulist_name *l) {
+    assert(l->size > 0);
+    return l->head->dat[l->head->begin];
+}
+
+/**
+ * @brief Returns the last element of the list.
+ * @param l The list to query.
+ * @return The last element of the list.
+ */
+static inline cgs_ulist_type CGS_ULIST(back)(cgs_ulist_name *l) {
+    assert(l->size > 0);
+    return l->tail->dat[l->tail->end - 1];
+}
+
+/**
+ * @brief Pop an element from the front of the list and return it.
+ * @param l The list to modify.
+ * @return The popped element.
+ */
+static inline cgs_ulist_type CGS_ULIST(pop_front)(cgs_ulist_name *l) {
+    CGS_ULIST(node) *node = l->head;
+    cgs_ulist_type res;
+    assert(l->size > 0);
+    res = node->dat[node->begin++];
+    if (node->begin == node->end) {
+        CGS_ULIST_INTERNAL(remove_node)(l, node);
+    }
+    l->size--;
+    return res;
+}
+
+/**
+ * @brief Pop an element from the back of the list and return it.
+ * @param l The list to modify.
+ * @return The popped element.
+ */
+static inline cgs_ulist_type CGS_ULIST(pop_back)(cgs_ulist_name *l) {
+    CGS_ULIST(node) *node = l->tail;
+    cgs_ulist_type res;
+    assert(l->size > 0);
+    res = node->dat[--node->end];
+    if (node->begin == node->end) {
+        CGS_ULIST_INTERNAL(remove_node)(l, node);
+    }
+    l->size--;
+    return res;
+}
+
+/**
+ * @brief Move all elements of another list to the back of the list in O(1).
+ * Both lists must use the same allocator context. The other list is left empty.
+ * @param l The list to append to.
+ * @param other The list to move the elements from.
+ */
+static inline void CGS_ULIST(splice)(cgs_ulist_name *l, cgs_ulist_name *other) {
+    if (other->head == NULL) {
+        return;
+    }
+    if (l->tail != NULL) {
+        l->tail->next = other->head;
+        other->head->prev = l->tail;
+    } else {
+        l->head = other->head;
+    }
+    l->tail = other->tail;
+    l->size += other->size;
+    other->head = other->tail = NULL;
+    other->size = 0;
+}
+
+/**
+ * @brief Removes all elements from the list.
+ * @param l The list to clear.
+ */
+static inline void CGS_ULIST(clear)(cgs_ulist_name *l) {
+    CGS_ULIST(node) *node = l->head, *next;
+    while (node != NULL) {
+        next = node->next;
+        cgs_ulist_free(l->alloc_ctx, node, sizeof(CGS_ULIST(node)));
+        node = next;
+    }
+    l->head = l->tail = NULL;
+    l->size = 0;
+}
+
+/**
+ * @brief Frees the data structures of a list initialized with init(), but not the list itself.
+ * The list is left empty, and may still be used afterwards.
+ * @param l The list to destroy.
+ */
+static inline void CGS_ULIST(destroy)(cgs_ulist_name *l) {
+    CGS_ULIST(clear)(l);
+}
+
+/**
+ * @brief Frees the list and all of its data structures.
+ * @param l The list to free.
+ */
+static inline void CGS_ULIST(free)(cgs_ulist_name *l) {
+    CGS_ULIST(clear)(l);
+    cgs_ulist_free(l->alloc_ctx, l, sizeof(cgs_ulist_name));
+}
+
+#undef cgs_ulist_type
+#undef cgs_ulist_name
+#undef cgs_ulist_node_capacity
+#undef cgs_ulist_malloc
+#undef cgs_ulist_free
+#undef CGS_ULIST_CAPACITY
+#endif /* semi include guard */
@@ -6,6 +6,37 @@
  * - cgs_vec_name: The name of the generated vector type. (e.g. `my_vector`)
  * - cgs_vec_type: The type of the elements. (e.g. `int`, `char *`)
  *
+ * Define one of the following macros to describe the element type. Searching then uses SSE2 or AVX2,
+ * if the compiler targets them, and min(), max() and sum() are generated for arithmetic types.
+ * - cgs_vec_integral: The elements are integers. (e.g. `int`, `uint8_t`)
+ * - cgs_vec_floating: The elements are `float` or `double`.
+ * - cgs_vec_pointer: The elements are pointers.
+ * - cgs_vec_sum_type: Optional. The type that sum() accumulates and returns. (Default: cgs_vec_type)
+ *
+ * For other element types, searching compares elements one by one with the following optional macro.
+ * - cgs_vec_equals(a, b): Whether two elements are equal. (Default: `(a) == (b)`)
+ *
+ * Sorting, binary search and the sorted-set operations are generated if one of the macros above is defined,
+ * or if the following macro is defined. radix_sort() is generated for integral and floating-point types.
+ * - cgs_vec_less(a, b): Whether a is ordered before b. (Default: `(a) < (b)`)
+ *
+ * - cgs_vec_inline_capacity: Optional. If defined, the first cgs_vec_inline_capacity elements are stored inside
+ *   the vector struct, and the heap is only used once the vector grows past them. Since the vector then points
+ *   into itself, it must not be copied or moved with memcpy after it is initialized.
+ *
+ * - cgs_vec_mmap: Optional. If defined, the array lives in a memory mapping instead of the heap, and the OS pages it
+ *   in and out on demand. init() maps anonymous memory, while init_file() maps a file, which keeps the elements
+ *   and can be reopened later. The mapping grows with mremap() if `_GNU_SOURCE` is defined before the system
+ *   headers, and otherwise by mapping it again. advise() passes access hints to madvise(), and sync() writes the
+ *   file with msync(). Requires POSIX, so define `_GNU_SOURCE` or `_DEFAULT_SOURCE` when compiling with a strict
+ *   `-std=c99`/`-std=c11`. The elements of a file should not contain pointers. If the mapping cannot grow,
+ *   the program is aborted. Cannot be combined with cgs_vec_inline_capacity.
+ *
+ * The following macros are optional, and replace the global allocator hooks of cgs_common.h for this vector.
+ * - cgs_vec_malloc(ctx, size): Allocates memory.
+ * - cgs_vec_realloc(ctx, ptr, old_size, size): Resizes memory allocated with cgs_vec_malloc.
+ * - cgs_vec_free(ctx, ptr, size): Frees memory allocated with cgs_vec_malloc.
+ *
  * After the header is included, define the macro `cgs_<cgs_vec_name>` to 1.
  * This is to prevent clashes from multiple includes.
  *
@@ -29,6 +60,185 @@
 #define CGS_VECTOR_H
 
 #define CGS_VECTOR(name) CGS_CAT(cgs_vec_name, name)
+#define CGS_VECTOR_INTERNAL(name) CGS_CAT_INTERNAL(cgs_vec_name, name)
+
+/* SIMD search kernels, shared by every vector type. The vector width in bytes is CGS_VEC_SIMD. */
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CGS_VEC_SIMD 32
+typedef __m256i cgs_vec_simd;
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CGS_VEC_SIMD 16
+typedef __m128i cgs_vec_simd;
+#endif
+
+/* Whether elements of the given size can be searched with the SIMD kernels. */
+#define CGS_VEC_SIMD_SIZE(size) ((size) == 1 || (size) == 2 || (size) == 4 || (size) == 8)
+
+#ifdef CGS_VEC_SIMD
+
+/** @private Broadcasts the element at key to every lane. */
+static inline cgs_vec_simd cgs_vec_simd_splat(const void *key, size_t size) {
+    int8_t k8;
+    int16_t k16;
+    int32_t k32;
+    int64_t k64;
+    switch (size) {
+    case 1:
+        memcpy(&k8, key, 1);
+#ifdef __AVX2__
+        return _mm256_set1_epi8(k8);
+#else
+        return _mm_set1_epi8(k8);
+#endif
+    case 2:
+        memcpy(&k16, key, 2);
+#ifdef __AVX2__
+        return _mm256_set1_epi16(k16);
+#else
+        return _mm_set1_epi16(k16);
+#endif
+    case 4:
+        memcpy(&k32, key, 4);
+#ifdef __AVX2__
+        return _mm256_set1_epi32(k32);
+#else
+        return _mm_set1_epi32(k32);
+#endif
+    default:
+        memcpy(&k64, key, 8);
+#ifdef __AVX2__
+        return _mm256_set1_epi64x(k64);
+#else
+        return _mm_set1_epi64x(k64);
+#endif
+    }
+}
+
+/**
+ * @private Compares the elements of a block with the broadcast key.
+ * Floating-point elements are compared with `==`, and other elements bit by bit.
+ * @return A mask with the bits of the matching elements' bytes set.
+ */
+static inline uint32_t cgs_vec_simd_match(const void *p, cgs_vec_simd key, size_t size, bool floating) {
+#ifdef __AVX2__
+    __m256i block = _mm256_loadu_si256((const __m256i *) p);
+    __m256i eq;
+    if (floating && size == 4) {
+        eq = _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(block), _mm256_castsi256_ps(key), _CMP_EQ_OQ));
+    } else if (floating && size == 8) {
+        eq = _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(block), _mm256_castsi256_pd(key), _CMP_EQ_OQ));
+    } else if (size == 1) {
+        eq = _mm256_cmpeq_epi8(block, key);
+    } else if (size == 2) {
+        eq = _mm256_cmpeq_epi16(block, key);
+    } else if (size == 4) {
+        eq = _mm256_cmpeq_epi32(block, key);
+    } else {
+        eq = _mm256_cmpeq_epi64(block, key);
+    }
+    return (uint32_t) _mm256_movemask_epi8(eq);
+#else
+    __m128i block = _mm_loadu_si128((const __m128i *) p);
+    __m128i eq;
+    if (floating && size == 4) {
+        eq = _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(block), _mm_castsi128_ps(key)));
+    } else if (floating && size == 8) {
+        eq = _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(block), _mm_castsi128_pd(key)));
+    } else if (size == 1) {
+        eq = _mm_cmpeq_epi8(block, key);
+    } else if (size == 2) {
+        eq = _mm_cmpeq_epi16(block, key);
+    } else if (size == 4) {
+        eq = _mm_cmpeq_epi32(block, key);
+    } else {
+        /* SSE2 has no 64-bit compare: both 32-bit halves must match */
+        eq = _mm_cmpeq_epi32(block, key);
+        eq = _mm_and_si128(eq, _mm_shuffle_epi32(eq, _MM_SHUFFLE(2, 3, 0, 1)));
+    }
+    return (uint32_t) _mm_movemask_epi8(eq);
+#endif
+}
+
+/** @private Like cgs_vec_simd_match(), for a partial block of the given number of bytes. */
+static inline uint32_t cgs_vec_simd_match_tail(const char *p, size_t bytes, cgs_vec_simd key, size_t size, bool floating) {
+    char block[CGS_VEC_SIMD] = { 0 };
+    memcpy(block, p, bytes);
+    return cgs_vec_simd_match(block, key, size, floating) & (((uint32_t) 1 << bytes) - 1);
+}
+
+/** @private Returns the index of the first element equal to key, or -1 if there are no matches. */
+static inline size_t cgs_vec_simd_find(const void *arr, size_t n, const void *key, size_t size, bool floating) {
+    const char *a = arr;
+    cgs_vec_simd k = cgs_vec_simd_splat(key, size);
+    size_t bytes = n * size, i = 0;
+    uint32_t m0, m1, m2, m3;
+    /* test four blocks per branch, so that the loop is bound by memory rather than by branches */
+    for (; i + 4 * CGS_VEC_SIMD <= bytes; i += 4 * CGS_VEC_SIMD) {
+        m0 = cgs_vec_simd_match(a + i, k, size, floating);
+        m1 = cgs_vec_simd_match(a + i + CGS_VEC_SIMD, k, size, floating);
+        m2 = cgs_vec_simd_match(a + i + 2 * CGS_VEC_SIMD, k, size, floating);
+        m3 = cgs_vec_simd_match(a + i + 3 * CGS_VEC_SIMD, k, size, floating);
+        if (m0 | m1 | m2 | m3) {
+            break;
+        }
+    }
+    for (; i + CGS_VEC_SIMD <= bytes; i += CGS_VEC_SIMD) {
+        m0 = cgs_vec_simd_match(a + i, k, size, floating);
+        if (m0) {
+            return (i + cgs_ctz32(m0)) / size;
+        }
+    }
+    if (i < bytes && (m0 = cgs_vec_simd_match_tail(a + i, bytes - i, k, size, floating))) {
+        return (i + cgs_ctz32(m0)) / size;
+    }
+    return -1;
+}
+
+/** @private Returns the index of the last element equal to key, or -1 if there are no matches. */
+static inline size_t cgs_vec_simd_rfind(const void *arr, size_t n, const void *key, size_t size, bool floating) {
+    const char *a = arr;
+    cgs_vec_simd k = cgs_vec_simd_splat(key, size);
+    size_t bytes = n * size, i = bytes - bytes % CGS_VEC_SIMD;
+    uint32_t m;
+    if (i < bytes && (m = cgs_vec_simd_match_tail(a + i, bytes - i, k, size, floating))) {
+        return (i + 31 - cgs_clz32(m)) / size;
+    }
+    for (; i > 0; i -= CGS_VEC_SIMD) {
+        m = cgs_vec_simd_match(a + i - CGS_VEC_SIMD, k, size, floating);
+        if (m) {
+            return (i - CGS_VEC_SIMD + 31 - cgs_clz32(m)) / size;
+        }
+    }
+    return -1;
+}
+
+/** @private Returns the number of elements equal to key. */
+static inline size_t cgs_vec_simd_count(const void *arr, size_t n, const void *key, size_t size, bool floating) {
+    const char *a = arr;
+    cgs_vec_simd k = cgs_vec_simd_splat(key, size);
+    size_t bytes = n * size, i = 0, res = 0;
+    for (; i + CGS_VEC_SIMD <= bytes; i += CGS_VEC_SIMD) {
+        res += cgs_popcount32(cgs_vec_simd_match(a + i, k, size, floating));
+    }
+    if (i < bytes) {
+        res += cgs_popcount32(cgs_vec_simd_match_tail(a + i, bytes - i, k, size, floating));
+    }
+    return res / size;
+}
+
+#endif
+
+/* The header at the start of the file of a memory-mapped vector. The elements start CGS_VEC_MMAP_HEADER bytes in. */
+typedef struct cgs_vec_mmap_header {
+    uint64_t magic;
+    uint64_t elem_size;
+    uint64_t size;
+} cgs_vec_mmap_header;
+
+#define CGS_VEC_MMAP_MAGIC 0x314345565347430aull
+#define CGS_VEC_MMAP_HEADER 64
 
 #endif
 
@@ -39,23 +249,243 @@ typedef cgs_vec_type CGS_VECTOR(type);
 
 #define CGS_VECTOR_INIT_CAPACITY 8
 
+#ifndef cgs_vec_equals
+#define cgs_vec_equals(a, b) ((a) == (b))
+#endif
+
+/* Whether this vector is searched with the SIMD kernels. */
+#if defined(CGS_VEC_SIMD) && (defined(cgs_vec_integral) || defined(cgs_vec_floating) || defined(cgs_vec_pointer))
+#define CGS_VECTOR_SIMD_SEARCH CGS_VEC_SIMD_SIZE(sizeof(cgs_vec_type))
+#else
+#define CGS_VECTOR_SIMD_SEARCH 0
+#endif
+#ifdef cgs_vec_floating
+#define CGS_VECTOR_FLOATING true
+#else
+#define CGS_VECTOR_FLOATING false
+#endif
+
+#ifndef cgs_vec_sum_type
+#define cgs_vec_sum_type cgs_vec_type
+#endif
+
+#if defined(cgs_vec_less) || defined(cgs_vec_integral) || defined(cgs_vec_floating) || defined(cgs_vec_pointer)
+#define CGS_VECTOR_ORDERED
+#ifndef cgs_vec_less
+#define cgs_vec_less(a, b) ((a) < (b))
+#endif
+#endif
+
+#ifdef cgs_vec_mmap
+#ifdef cgs_vec_inline_capacity
+#error "cgs_vec_mmap and cgs_vec_inline_capacity cannot be defined at the same time"
+#endif
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifndef cgs_vec_malloc
+#define cgs_vec_malloc CGS_MALLOC
+#endif
+#ifndef cgs_vec_realloc
+#define cgs_vec_realloc CGS_REALLOC
+#endif
+#ifndef cgs_vec_free
+#define cgs_vec_free CGS_FREE
+#endif
+
 typedef struct cgs_vec_name {
     cgs_vec_type *array;
     size_t size, capacity;
+    void *alloc_ctx;
+#ifdef cgs_vec_inline_capacity
+    cgs_vec_type inline_array[cgs_vec_inline_capacity];
+#endif
+#ifdef cgs_vec_mmap
+    cgs_vec_mmap_header *map; /* the start of the mapping, followed by the array */
+    int fd; /* the mapped file, or -1 for anonymous memory */
+#endif
 } cgs_vec_name;
 
+#ifdef cgs_vec_mmap
+/** @private Returns the size of a mapping that holds the given number of elements. */
+static inline size_t CGS_VECTOR_INTERNAL(map_size)(size_t capacity) {
+    return CGS_VEC_MMAP_HEADER + capacity * sizeof(cgs_vec_type);
+}
+
+/** @private Maps the given number of bytes of the vector's file, or anonymous memory if it has none. */
+static inline cgs_vec_mmap_header *CGS_VECTOR_INTERNAL(map)(cgs_vec_name *v, size_t size) {
+    void *res = mmap(NULL, size, PROT_READ | PROT_WRITE, v->fd >= 0 ? MAP_SHARED : MAP_PRIVATE | MAP_ANONYMOUS,
+                     v->fd, 0);
+    return res == MAP_FAILED ? NULL : (cgs_vec_mmap_header *) res;
+}
+
+/** @private Points the vector to a new mapping that holds the given number of elements. */
+static inline void CGS_VECTOR_INTERNAL(set_map)(cgs_vec_name *v, cgs_vec_mmap_header *map, size_t capacity) {
+    v->map = map;
+    v->array = (cgs_vec_type *) ((char *) map + CGS_VEC_MMAP_HEADER);
+    v->capacity = capacity;
+}
+
+/** @private Grows or shrinks the mapping to hold the given number of elements. */
+static inline bool CGS_VECTOR_INTERNAL(remap)(cgs_vec_name *v, size_t capacity) {
+    size_t old_size = CGS_VECTOR_INTERNAL(map_size)(v->capacity), size = CGS_VECTOR_INTERNAL(map_size)(capacity);
+    cgs_vec_mmap_header *map;
+    /* the file must cover the whole mapping before it grows, and may only be cut after it shrinks */
+    if (v->fd >= 0 && size > old_size && ftruncate(v->fd, (off_t) size) != 0) {
+        return false;
+    }
+#ifdef MREMAP_MAYMOVE
+    void *res = mremap(v->map, old_size, size, MREMAP_MAYMOVE);
+    map = res == MAP_FAILED ? NULL : (cgs_vec_mmap_header *) res;
+#else
+    map = CGS_VECTOR_INTERNAL(map)(v, size);
+    if (map != NULL) {
+        if (v->fd < 0) {
+            memcpy(map, v->map, size < old_size ? size : old_size);
+        }
+        munmap(v->map, old_size);
+    }
+#endif
+    if (map == NULL) {
+        return false;
+    }
+    CGS_VECTOR_INTERNAL(set_map)(v, map, capacity);
+    if (v->fd >= 0 && size < old_size && ftruncate(v->fd, (off_t) size) != 0) {
+        return false;
+    }
+    return true;
+}
+
 /**
- * @brief Allocate and initialize a new vector.
- * @return A newly allocated and initialized vector.
+ * @brief Initialize a vector in place, with its elements in a file.
+ * If the file was written by a vector of the same element size, its elements are loaded lazily by the OS,
+ * and the vector starts with them. Otherwise, the file is created or overwritten as an empty vector.
+ * @param v The vector to initialize.
+ * @param path The path of the file.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return Whether the file could be opened and mapped. If not, the vector is left uninitialized.
  */
-static inline cgs_vec_name *CGS_VECTOR(new)() {
-    cgs_vec_name *v = malloc(sizeof(cgs_vec_name));
+static inline bool CGS_VECTOR(init_file)(cgs_vec_name *v, const char *path, void *ctx) {
+    struct stat st;
+    cgs_vec_mmap_header *map;
+    size_t capacity = CGS_VECTOR_INIT_CAPACITY;
+    bool reopen;
+    v->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (v->fd < 0) {
+        return false;
+    }
+    if (fstat(v->fd, &st) != 0) {
+        close(v->fd);
+        return false;
+    }
+    reopen = (size_t) st.st_size >= CGS_VECTOR_INTERNAL(map_size)(1);
+    if (reopen) {
+        capacity = ((size_t) st.st_size - CGS_VEC_MMAP_HEADER) / sizeof(cgs_vec_type);
+    } else if (ftruncate(v->fd, (off_t) CGS_VECTOR_INTERNAL(map_size)(capacity)) != 0) {
+        close(v->fd);
+        return false;
+    }
+    map = CGS_VECTOR_INTERNAL(map)(v, CGS_VECTOR_INTERNAL(map_size)(capacity));
+    if (map == NULL) {
+        close(v->fd);
+        return false;
+    }
+    if (!reopen || map->magic != CGS_VEC_MMAP_MAGIC || map->elem_size != sizeof(cgs_vec_type) ||
+        map->size > capacity) {
+        map->magic = CGS_VEC_MMAP_MAGIC;
+        map->elem_size = sizeof(cgs_vec_type);
+        map->size = 0;
+    }
+    CGS_VECTOR_INTERNAL(set_map)(v, map, capacity);
+    v->size = (size_t) map->size;
+    v->alloc_ctx = ctx;
+    return true;
+}
+
+/**
+ * @brief Write the elements of a vector initialized with init_file() to its file.
+ * The size of the vector is only recorded in the file by sync() and destroy().
+ * @param v The vector to synchronize.
+ * @param wait Whether to wait until the data is written, or only to schedule the write.
+ * @return Whether the write succeeded. Always true for an anonymous mapping.
+ */
+static inline bool CGS_VECTOR(sync)(cgs_vec_name *v, bool wait) {
+    if (v->fd < 0) {
+        return true;
+    }
+    v->map->size = v->size;
+    return msync(v->map, CGS_VECTOR_INTERNAL(map_size)(v->size), wait ? MS_SYNC : MS_ASYNC) == 0;
+}
+
+/**
+ * @brief Tell the OS how the elements will be accessed, so that it can page them in accordingly.
+ * The advice applies to the current mapping, so it should be given again after the vector grows.
+ * @param v The vector to use.
+ * @param advice An madvise() hint, such as MADV_SEQUENTIAL, MADV_RANDOM or MADV_WILLNEED.
+ * @return Whether the hint was accepted.
+ */
+static inline bool CGS_VECTOR(advise)(cgs_vec_name *v, int advice) {
+    return madvise(v->map, CGS_VECTOR_INTERNAL(map_size)(v->capacity), advice) == 0;
+}
+#endif
+
+/**
+ * @brief Initialize a vector in place, e.g. one embedded in another struct or on the stack.
+ * With cgs_vec_inline_capacity, this does not allocate any memory.
+ * @param v The vector to initialize.
+ * @param ctx The context pointer passed to the allocator hooks.
+ */
+static inline void CGS_VECTOR(init)(cgs_vec_name *v, void *ctx) {
     v->size = 0;
+#if defined(cgs_vec_inline_capacity)
+    v->capacity = cgs_vec_inline_capacity;
+    v->array = v->inline_array;
+#elif defined(cgs_vec_mmap)
+    v->fd = -1;
+    cgs_vec_mmap_header *map = CGS_VECTOR_INTERNAL(map)(v, CGS_VECTOR_INTERNAL(map_size)(CGS_VECTOR_INIT_CAPACITY));
+    if (map == NULL) {
+        abort();
+    }
+    CGS_VECTOR_INTERNAL(set_map)(v, map, CGS_VECTOR_INIT_CAPACITY);
+#else
     v->capacity = CGS_VECTOR_INIT_CAPACITY;
-    v->array = malloc(sizeof(cgs_vec_type) * CGS_VECTOR_INIT_CAPACITY);
+    v->array = cgs_vec_malloc(ctx, sizeof(cgs_vec_type) * CGS_VECTOR_INIT_CAPACITY);
+#endif
+    v->alloc_ctx = ctx;
+}
+
+/**
+ * @brief Allocate and initialize a new vector that uses the given allocator context.
+ * @param ctx The context pointer passed to the allocator hooks.
+ * @return A newly allocated and initialized vector.
+ */
+static inline cgs_vec_name *CGS_VECTOR(new_with_ctx)(void *ctx) {
+    cgs_vec_name *v = cgs_vec_malloc(ctx, sizeof(cgs_vec_name));
+    CGS_VECTOR(init)(v, ctx);
     return v;
 }
 
+/**
+ * @brief Allocate and initialize a new vector.
+ * @return A newly allocated and initialized vector.
+ */
+static inline cgs_vec_name *CGS_VECTOR(new)() {
+    return CGS_VECTOR(new_with_ctx)(NULL);
+}
+
+/** @private Whether the elements are stored inside the vector struct. */
+static inline bool CGS_VECTOR_INTERNAL(is_inline)(cgs_vec_name *v) {
+#ifdef cgs_vec_inline_capacity
+    return v->array == v->inline_array;
+#else
+    (void) v;
+    return false;
+#endif
+}
+
 /**
  * @brief Get the element at a given index in the vector.
  * @param v The vector to query.
@@ -95,8 +525,54 @@ static inline bool CGS_VECTOR(empty)(cgs_vec_name *v) {
  */
 static inline void CGS_VECTOR(reserve)(cgs_vec_name *v, size_t s) {
     if (s > v->capacity) {
-        v->capacity = s > v->capacity * 2 ? s : v->capacity * 2;
-        v->array = realloc(v->array, sizeof(cgs_vec_type) * v->capacity);
+        size_t capacity = s > v->capacity * 2 ? s : v->capacity * 2;
+#ifdef cgs_vec_mmap
+        if (!CGS_VECTOR_INTERNAL(remap)(v, capacity)) {
+            abort();
+        }
+        return;
+#endif
+        if (CGS_VECTOR_INTERNAL(is_inline)(v)) {
+            cgs_vec_type *array = cgs_vec_malloc(v->alloc_ctx, sizeof(cgs_vec_type) * capacity);
+            memcpy(array, v->array, sizeof(cgs_vec_type) * v->size);
+            v->array = array;
+        } else {
+            v->array = cgs_vec_realloc(v->alloc_ctx, v->array, sizeof(cgs_vec_type) * v->capacity,
+                                       sizeof(cgs_vec_type) * capacity);
+        }
+        v->capacity = capacity;
+    }
+}
+
+/**
+ * @brief Release the capacity of the vector that is not used by its elements.
+ * With cgs_vec_inline_capacity, the elements move back to the inline storage if they fit in it.
+ * @param v The vector to use.
+ */
+static inline void CGS_VECTOR(shrink_to_fit)(cgs_vec_name *v) {
+    size_t capacity = v->size > CGS_VECTOR_INIT_CAPACITY ? v->size : CGS_VECTOR_INIT_CAPACITY;
+    if (CGS_VECTOR_INTERNAL(is_inline)(v)) {
+        return;
+    }
+#ifdef cgs_vec_inline_capacity
+    if (v->size <= cgs_vec_inline_capacity) {
+        memcpy(v->inline_array, v->array, sizeof(cgs_vec_type) * v->size);
+        cgs_vec_free(v->alloc_ctx, v->array, sizeof(cgs_vec_type) * v->capacity);
+        v->array = v->inline_array;
+        v->capacity = cgs_vec_inline_capacity;
+        return;
+    }
+#endif
+#ifdef cgs_vec_mmap
+    if (capacity < v->capacity) {
+        CGS_VECTOR_INTERNAL(remap)(v, capacity);
+    }
+    return;
+#endif
+    if (capacity < v->capacity) {
+        v->array = cgs_vec_realloc(v->alloc_ctx, v->array, sizeof(cgs_vec_type) * v->capacity,
+                                   sizeof(cgs_vec_type) * capacity);
+        v->capacity = capacity;
     }
 }
 
@@ -149,22 +625,557 @@ static inline cgs_vec_type CGS_VECTOR(erase)(cgs_vec_name *v, size_t pos) {
     return res;
 }
 
+/**
+ * @brief Push n elements to the end of the vector.
+ * @param v The vector to use.
+ * @param arr The elements to push. Must not point into the vector.
+ * @param n The number of elements to push.
+ */
+static inline void CGS_VECTOR(append_array)(cgs_vec_name *v, const CGS_VECTOR(type) *arr, size_t n) {
+    CGS_VECTOR(reserve)(v, v->size + n);
+    memcpy(&v->array[v->size], arr, n * sizeof(cgs_vec_type));
+    v->size += n;
+}
+
+/**
+ * @brief Insert n elements at a given position in the vector.
+ * @param v The vector to use.
+ * @param pos The position to insert the elements.
+ * @param arr The elements to insert. Must not point into the vector.
+ * @param n The number of elements to insert.
+ */
+static inline void CGS_VECTOR(insert_range)(cgs_vec_name *v, size_t pos, const CGS_VECTOR(type) *arr, size_t n) {
+    assert(pos <= v->size);
+    CGS_VECTOR(reserve)(v, v->size + n);
+    memmove(&v->array[pos + n], &v->array[pos], (v->size - pos) * sizeof(cgs_vec_type));
+    memcpy(&v->array[pos], arr, n * sizeof(cgs_vec_type));
+    v->size += n;
+}
+
+/**
+ * @brief Remove n elements starting from a given position in the vector.
+ * @param v The vector to use.
+ * @param pos The position of the first element to remove.
+ * @param n The number of elements to remove.
+ */
+static inline void CGS_VECTOR(erase_range)(cgs_vec_name *v, size_t pos, size_t n) {
+    assert(pos <= v->size && n <= v->size - pos);
+    memmove(&v->array[pos], &v->array[pos + n], (v->size - pos - n) * sizeof(cgs_vec_type));
+    v->size -= n;
+}
+
+/**
+ * @brief Remove an element at a given position in the vector by moving the last element into its place.
+ * Takes O(1) time, but does not preserve the order of the elements.
+ * @param v The vector to use.
+ * @param pos The position of the element to remove.
+ * @return The removed element.
+ */
+static inline cgs_vec_type CGS_VECTOR(swap_remove)(cgs_vec_name *v, size_t pos) {
+    cgs_vec_type res;
+    assert(pos < v->size);
+    res = v->array[pos];
+    v->array[pos] = v->array[--v->size];
+    return res;
+}
+
+/**
+ * @brief Change the number of elements in the vector.
+ * New elements are set to fill, and elements past the new size are removed.
+ * @param v The vector to use.
+ * @param n The new size.
+ * @param fill The element to set new elements to.
+ */
+static inline void CGS_VECTOR(resize)(cgs_vec_name *v, size_t n, cgs_vec_type fill) {
+    CGS_VECTOR(reserve)(v, n);
+    for (size_t i = v->size; i < n; i++) {
+        v->array[i] = fill;
+    }
+    v->size = n;
+}
+
+/**
+ * @brief Remove every element that satisfies a predicate, in a single pass.
+ * The remaining elements keep their order.
+ * @param v The vector to use.
+ * @param pred Returns whether the element should be removed.
+ * @param ctx A pointer passed to the predicate.
+ * @return The number of removed elements.
+ */
+static inline size_t CGS_VECTOR(remove_if)(cgs_vec_name *v, bool (*pred)(cgs_vec_type, void *), void *ctx) {
+    size_t kept = 0, i = 0;
+    /* nothing has to move until the first removed element */
+    while (i < v->size && !pred(v->array[i], ctx)) {
+        i++;
+    }
+    kept = i;
+    for (; i < v->size; i++) {
+        if (!pred(v->array[i], ctx)) {
+            v->array[kept++] = v->array[i];
+        }
+    }
+    i = v->size - kept;
+    v->size = kept;
+    return i;
+}
+
 /**
  * @brief Finds the index of the first element identical to e.
  * Returns -1 if there are no matches.
- * @param l The vector to query.
+ * @param v The vector to query.
  * @param e The element to find.
  * @return The index of the first element identical to e, or -1 if there are no matches.
  */
 static inline size_t CGS_VECTOR(find)(cgs_vec_name *v, cgs_vec_type e) {
+#ifdef CGS_VEC_SIMD
+    if (CGS_VECTOR_SIMD_SEARCH) {
+        return cgs_vec_simd_find(v->array, v->size, &e, sizeof(cgs_vec_type), CGS_VECTOR_FLOATING);
+    }
+#endif
     for (size_t i = 0; i < v->size; i++) {
-        if (v->array[i] == e) {
+        if (cgs_vec_equals(v->array[i], e)) {
             return i;
         }
     }
     return -1;
 }
 
+/**
+ * @brief Finds the index of the last element identical to e.
+ * Returns -1 if there are no matches.
+ * @param v The vector to query.
+ * @param e The element to find.
+ * @return The index of the last element identical to e, or -1 if there are no matches.
+ */
+static inline size_t CGS_VECTOR(rfind)(cgs_vec_name *v, cgs_vec_type e) {
+#ifdef CGS_VEC_SIMD
+    if (CGS_VECTOR_SIMD_SEARCH) {
+        return cgs_vec_simd_rfind(v->array, v->size, &e, sizeof(cgs_vec_type), CGS_VECTOR_FLOATING);
+    }
+#endif
+    for (size_t i = v->size; i > 0; i--) {
+        if (cgs_vec_equals(v->array[i - 1], e)) {
+            return i - 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Counts the elements identical to e.
+ * @param v The vector to query.
+ * @param e The element to count.
+ * @return The number of elements identical to e.
+ */
+static inline size_t CGS_VECTOR(count)(cgs_vec_name *v, cgs_vec_type e) {
+    size_t res = 0;
+#ifdef CGS_VEC_SIMD
+    if (CGS_VECTOR_SIMD_SEARCH) {
+        return cgs_vec_simd_count(v->array, v->size, &e, sizeof(cgs_vec_type), CGS_VECTOR_FLOATING);
+    }
+#endif
+    for (size_t i = 0; i < v->size; i++) {
+        res += cgs_vec_equals(v->array[i], e);
+    }
+    return res;
+}
+
+/**
+ * @brief Check whether the vector contains an element identical to e.
+ * @param v The vector to query.
+ * @param e The element to find.
+ * @return Whether the vector contains e.
+ */
+static inline bool CGS_VECTOR(contains)(cgs_vec_name *v, cgs_vec_type e) {
+    return CGS_VECTOR(find)(v, e) != (size_t) -1;
+}
+
+#if defined(cgs_vec_integral) || defined(cgs_vec_floating)
+/*
+ * The reductions keep four independent accumulators, so that consecutive iterations do not wait for each other
+ * and the compiler is free to vectorize them.
+ */
+
+/**
+ * @brief Finds the smallest element of the vector.
+ * @param v The vector to query. Must not be empty.
+ * @return The smallest element.
+ */
+static inline cgs_vec_type CGS_VECTOR(min)(cgs_vec_name *v) {
+    cgs_vec_type m0, m1, m2, m3;
+    size_t i = 0;
+    assert(v->size > 0);
+    m0 = m1 = m2 = m3 = v->array[0];
+    for (; i + 4 <= v->size; i += 4) {
+        m0 = v->array[i] < m0 ? v->array[i] : m0;
+        m1 = v->array[i + 1] < m1 ? v->array[i + 1] : m1;
+        m2 = v->array[i + 2] < m2 ? v->array[i + 2] : m2;
+        m3 = v->array[i + 3] < m3 ? v->array[i + 3] : m3;
+    }
+    for (; i < v->size; i++) {
+        m0 = v->array[i] < m0 ? v->array[i] : m0;
+    }
+    m0 = m1 < m0 ? m1 : m0;
+    m2 = m3 < m2 ? m3 : m2;
+    return m2 < m0 ? m2 : m0;
+}
+
+/**
+ * @brief Finds the largest element of the vector.
+ * @param v The vector to query. Must not be empty.
+ * @return The largest element.
+ */
+static inline cgs_vec_type CGS_VECTOR(max)(cgs_vec_name *v) {
+    cgs_vec_type m0, m1, m2, m3;
+    size_t i = 0;
+    assert(v->size > 0);
+    m0 = m1 = m2 = m3 = v->array[0];
+    for (; i + 4 <= v->size; i += 4) {
+        m0 = v->array[i] > m0 ? v->array[i] : m0;
+        m1 = v->array[i + 1] > m1 ? v->array[i + 1] : m1;
+        m2 = v->array[i + 2] > m2 ? v->array[i + 2] : m2;
+        m3 = v->array[i + 3] > m3 ? v->array[i + 3] : m3;
+    }
+    for (; i < v->size; i++) {
+        m0 = v->array[i] > m0 ? v->array[i] : m0;
+    }
+    m0 = m1 > m0 ? m1 : m0;
+    m2 = m3 > m2 ? m3 : m2;
+    return m2 > m0 ? m2 : m0;
+}
+
+/**
+ * @brief Adds up the elements of the vector.
+ * Floating-point sums are rounded differently from a strictly sequential sum.
+ * @param v The vector to query.
+ * @return The sum of the elements, or 0 if the vector is empty.
+ */
+static inline cgs_vec_sum_type CGS_VECTOR(sum)(cgs_vec_name *v) {
+    cgs_vec_sum_type s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+    size_t i = 0;
+    for (; i + 4 <= v->size; i += 4) {
+        s0 += v->array[i];
+        s1 += v->array[i + 1];
+        s2 += v->array[i + 2];
+        s3 += v->array[i + 3];
+    }
+    for (; i < v->size; i++) {
+        s0 += v->array[i];
+    }
+    return (s0 + s1) + (s2 + s3);
+}
+#endif
+
+#ifdef CGS_VECTOR_ORDERED
+
+/** @private Sorts a short array with insertion sort. */
+static inline void CGS_VECTOR_INTERNAL(insertion_sort)(cgs_vec_type *a, size_t n) {
+    for (size_t i = 1; i < n; i++) {
+        cgs_vec_type e = a[i];
+        size_t j = i;
+        for (; j > 0 && cgs_vec_less(e, a[j - 1]); j--) {
+            a[j] = a[j - 1];
+        }
+        a[j] = e;
+    }
+}
+
+/** @private Moves the element at i down the max-heap a of size n. */
+static inline void CGS_VECTOR_INTERNAL(sift_down)(cgs_vec_type *a, size_t i, size_t n) {
+    cgs_vec_type e = a[i];
+    for (size_t child; (child = 2 * i + 1) < n; i = child) {
+        if (child + 1 < n && cgs_vec_less(a[child], a[child + 1])) {
+            child++;
+        }
+        if (!cgs_vec_less(e, a[child])) {
+            break;
+        }
+        a[i] = a[child];
+    }
+    a[i] = e;
+}
+
+/** @private Sorts an array with heapsort, which bounds the worst case of introsort. */
+static inline void CGS_VECTOR_INTERNAL(heap_sort)(cgs_vec_type *a, size_t n) {
+    for (size_t i = n / 2; i > 0; i--) {
+        CGS_VECTOR_INTERNAL(sift_down)(a, i - 1, n);
+    }
+    for (size_t i = n - 1; i > 0; i--) {
+        cgs_vec_type tmp = a[0];
+        a[0] = a[i];
+        a[i] = tmp;
+        CGS_VECTOR_INTERNAL(sift_down)(a, 0, i);
+    }
+}
+
+/** @private Swaps a[i] and a[j] if a[j] is ordered before a[i]. */
+static inline void CGS_VECTOR_INTERNAL(sort2)(cgs_vec_type *a, size_t i, size_t j) {
+    if (cgs_vec_less(a[j], a[i])) {
+        cgs_vec_type tmp = a[i];
+        a[i] = a[j];
+        a[j] = tmp;
+    }
+}
+
+/** @private Sorts an array with quicksort, switching to heapsort once depth runs out. */
+static inline void CGS_VECTOR_INTERNAL(intro_sort)(cgs_vec_type *a, size_t n, size_t depth) {
+    while (n > 16) {
+        if (depth-- == 0) {
+            CGS_VECTOR_INTERNAL(heap_sort)(a, n);
+            return;
+        }
+        /* the median of three is the pivot, and the other two stop the scans at the ends */
+        size_t mid = n / 2, i = 0, j = n - 1;
+        CGS_VECTOR_INTERNAL(sort2)(a, 0, mid);
+        CGS_VECTOR_INTERNAL(sort2)(a, mid, n - 1);
+        CGS_VECTOR_INTERNAL(sort2)(a, 0, mid);
+        cgs_vec_type pivot = a[mid];
+        for (;;) {
+            do {
+                i++;
+            } while (cgs_vec_less(a[i], pivot));
+            do {
+                j--;
+            } while (cgs_vec_less(pivot, a[j]));
+            if (i >= j) {
+                break;
+            }
+            cgs_vec_type tmp = a[i];
+            a[i] = a[j];
+            a[j] = tmp;
+        }
+        /* recurse into the smaller part, so that the stack stays logarithmic */
+        if (i < n - i) {
+            CGS_VECTOR_INTERNAL(intro_sort)(a, i, depth);
+            a += i;
+            n -= i;
+        } else {
+            CGS_VECTOR_INTERNAL(intro_sort)(a + i, n - i, depth);
+            n = i;
+        }
+    }
+    CGS_VECTOR_INTERNAL(insertion_sort)(a, n);
+}
+
+/**
+ * @brief Sorts the vector in ascending order with introsort.
+ * The sort is not stable, and takes O(n log n) time in the worst case.
+ * @param v The vector to sort.
+ */
+static inline void CGS_VECTOR(sort)(cgs_vec_name *v) {
+    size_t depth = 0;
+    for (size_t n = v->size; n > 1; n /= 2) {
+        depth += 2;
+    }
+    CGS_VECTOR_INTERNAL(intro_sort)(v->array, v->size, depth);
+}
+
+#if defined(cgs_vec_integral) || defined(cgs_vec_floating)
+/** @private Maps an element to an unsigned key with the same order. */
+static inline uint64_t CGS_VECTOR_INTERNAL(radix_key)(cgs_vec_type e) {
+    uint64_t key;
+#ifdef cgs_vec_floating
+    union {
+        cgs_vec_type e;
+        uint32_t u32;
+        uint64_t u64;
+    } bits;
+    bits.e = e;
+    if (sizeof(cgs_vec_type) == 4) {
+        key = bits.u32;
+    } else {
+        key = bits.u64;
+    }
+    /* negative numbers are ordered in reverse, and before the positive ones */
+    if (key >> (8 * sizeof(cgs_vec_type) - 1)) {
+        key = ~key;
+    } else {
+        key |= (uint64_t) 1 << (8 * sizeof(cgs_vec_type) - 1);
+    }
+#else
+    key = (uint64_t) e;
+    if ((cgs_vec_type) -1 < (cgs_vec_type) 1) {
+        /* signed: move the negative numbers before the positive ones */
+        key ^= (uint64_t) 1 << (8 * sizeof(cgs_vec_type) - 1);
+    }
+#endif
+    return key & ((uint64_t) -1 >> (64 - 8 * sizeof(cgs_vec_type)));
+}
+
+/**
+ * @brief Sorts the vector in ascending order with LSD radix sort.
+ * Takes O(n) time and a temporary array of n elements. Short vectors are sorted with sort() instead.
+ * Floating-point elements must not be NaN.
+ * @param v The vector to sort.
+ */
+static inline void CGS_VECTOR(radix_sort)(cgs_vec_name *v) {
+    /* 11-bit digits: fewer passes than bytes, while the counts of a pass still fit in the L1 cache */
+    enum { BITS = 11, BUCKETS = 1 << BITS, PASSES = (8 * sizeof(cgs_vec_type) + BITS - 1) / BITS };
+    size_t n = v->size;
+    cgs_vec_type *src = v->array, *dst, *tmp;
+    size_t *counts;
+    if (n < 256) {
+        CGS_VECTOR(sort)(v);
+        return;
+    }
+    counts = cgs_vec_malloc(v->alloc_ctx, sizeof(size_t) * PASSES * BUCKETS);
+    memset(counts, 0, sizeof(size_t) * PASSES * BUCKETS);
+    /* count the digits of every pass in a single read */
+    for (size_t i = 0; i < n; i++) {
+        uint64_t key = CGS_VECTOR_INTERNAL(radix_key)(src[i]);
+        for (size_t d = 0; d < PASSES; d++) {
+            counts[d * BUCKETS + ((key >> (BITS * d)) & (BUCKETS - 1))]++;
+        }
+    }
+    tmp = cgs_vec_malloc(v->alloc_ctx, sizeof(cgs_vec_type) * n);
+    dst = tmp;
+    uint64_t first_key = CGS_VECTOR_INTERNAL(radix_key)(src[0]);
+    for (size_t d = 0; d < PASSES; d++) {
+        size_t *count = &counts[d * BUCKETS];
+        if (count[(first_key >> (BITS * d)) & (BUCKETS - 1)] == n) {
+            continue; /* every element has the same digit */
+        }
+        for (size_t b = 0, offset = 0; b < BUCKETS; b++) {
+            size_t c = count[b];
+            count[b] = offset;
+            offset += c;
+        }
+        for (size_t i = 0; i < n; i++) {
+            dst[count[(CGS_VECTOR_INTERNAL(radix_key)(src[i]) >> (BITS * d)) & (BUCKETS - 1)]++] = src[i];
+        }
+        cgs_vec_type *swap = src;
+        src = dst;
+        dst = swap;
+    }
+    if (src != v->array) {
+        memcpy(v->array, src, sizeof(cgs_vec_type) * n);
+    }
+    cgs_vec_free(v->alloc_ctx, tmp, sizeof(cgs_vec_type) * n);
+    cgs_vec_free(v->alloc_ctx, counts, sizeof(size_t) * PASSES * BUCKETS);
+}
+#endif
+
+/**
+ * @brief Finds the first element of a sorted vector that is not ordered before e.
+ * @param v The sorted vector to query.
+ * @param e The element to compare with.
+ * @return The index of the first element not less than e, or the size of the vector if there is none.
+ */
+static inline size_t CGS_VECTOR(lower_bound)(cgs_vec_name *v, cgs_vec_type e) {
+    size_t lo = 0, n = v->size;
+    while (n > 0) {
+        size_t half = n / 2;
+        if (cgs_vec_less(v->array[lo + half], e)) {
+            lo += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Finds the first element of a sorted vector that is ordered after e.
+ * @param v The sorted vector to query.
+ * @param e The element to compare with.
+ * @return The index of the first element greater than e, or the size of the vector if there is none.
+ */
+static inline size_t CGS_VECTOR(upper_bound)(cgs_vec_name *v, cgs_vec_type e) {
+    size_t lo = 0, n = v->size;
+    while (n > 0) {
+        size_t half = n / 2;
+        if (!cgs_vec_less(e, v->array[lo + half])) {
+            lo += half + 1;
+            n -= half + 1;
+        } else {
+            n = half;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Check whether a sorted vector contains an element equivalent to e.
+ * @param v The sorted vector to query.
+ * @param e The element to find.
+ * @return Whether an element that is neither less nor greater than e exists.
+ */
+static inline bool CGS_VECTOR(binary_search)(cgs_vec_name *v, cgs_vec_type e) {
+    size_t i = CGS_VECTOR(lower_bound)(v, e);
+    return i < v->size && !cgs_vec_less(e, v->array[i]);
+}
+
+/**
+ * @brief Merges two sorted vectors into dst, replacing its contents.
+ * Equivalent elements are all kept, those of a first.
+ * @param dst The vector to store the result in. Must be distinct from a and b.
+ * @param a The first sorted vector.
+ * @param b The second sorted vector.
+ */
+static inline void CGS_VECTOR(merge)(cgs_vec_name *dst, cgs_vec_name *a, cgs_vec_name *b) {
+    size_t i = 0, j = 0, k = 0;
+    CGS_VECTOR(reserve)(dst, a->size + b->size);
+    while (i < a->size && j < b->size) {
+        dst->array[k++] = cgs_vec_less(b->array[j], a->array[i]) ? b->array[j++] : a->array[i++];
+    }
+    memcpy(&dst->array[k], &a->array[i], (a->size - i) * sizeof(cgs_vec_type));
+    k += a->size - i;
+    memcpy(&dst->array[k], &b->array[j], (b->size - j) * sizeof(cgs_vec_type));
+    dst->size = k + b->size - j;
+}
+
+/**
+ * @brief Stores the elements that appear in both sorted vectors in dst, replacing its contents.
+ * An element that appears m times in a and n times in b appears min(m, n) times in the result.
+ * @param dst The vector to store the result in. Must be distinct from a and b.
+ * @param a The first sorted vector.
+ * @param b The second sorted vector.
+ */
+static inline void CGS_VECTOR(intersection)(cgs_vec_name *dst, cgs_vec_name *a, cgs_vec_name *b) {
+    size_t i = 0, j = 0, k = 0;
+    CGS_VECTOR(reserve)(dst, a->size < b->size ? a->size : b->size);
+    while (i < a->size && j < b->size) {
+        if (cgs_vec_less(a->array[i], b->array[j])) {
+            i++;
+        } else if (cgs_vec_less(b->array[j], a->array[i])) {
+            j++;
+        } else {
+            dst->array[k++] = a->array[i++];
+            j++;
+        }
+    }
+    dst->size = k;
+}
+
+/**
+ * @brief Stores the elements that appear in either sorted vector in dst, replacing its contents.
+ * An element that appears m times in a and n times in b appears max(m, n) times in the result.
+ * @param dst The vector to store the result in. Must be distinct from a and b.
+ * @param a The first sorted vector.
+ * @param b The second sorted vector.
+ */
+static inline void CGS_VECTOR(union)(cgs_vec_name *dst, cgs_vec_name *a, cgs_vec_name *b) {
+    size_t i = 0, j = 0, k = 0;
+    CGS_VECTOR(reserve)(dst, a->size + b->size);
+    while (i < a->size && j < b->size) {
+        if (cgs_vec_less(a->array[i], b->array[j])) {
+            dst->array[k++] = a->array[i++];
+        } else if (cgs_vec_less(b->array[j], a->array[i])) {
+            dst->array[k++] = b->array[j++];
+        } else {
+            dst->array[k++] = a->array[i++];
+            j++;
+        }
+    }
+    memcpy(&dst->array[k], &a->array[i], (a->size - i) * sizeof(cgs_vec_type));
+    k += a->size - i;
+    memcpy(&dst->array[k], &b->array[j], (b->size - j) * sizeof(cgs_vec_type));
+    dst->size = k + b->size - j;
+}
+
+#endif
+
 /**
  * @brief Remove all elements from the vector.
  * @param v The vector to use.
@@ -173,15 +1184,48 @@ static inline void CGS_VECTOR(clear)(cgs_vec_name *v) {
     v->size = 0;
 }
 
+/**
+ * @brief Frees the data structures of a vector initialized with init(), but not the vector itself.
+ * The vector must be initialized again before it is used.
+ * @param v The vector to destroy.
+ */
+static inline void CGS_VECTOR(destroy)(cgs_vec_name *v) {
+#ifdef cgs_vec_mmap
+    if (v->fd >= 0) {
+        v->map->size = v->size;
+        close(v->fd);
+    }
+    munmap(v->map, CGS_VECTOR_INTERNAL(map_size)(v->capacity));
+    return;
+#endif
+    if (!CGS_VECTOR_INTERNAL(is_inline)(v)) {
+        cgs_vec_free(v->alloc_ctx, v->array, sizeof(cgs_vec_type) * v->capacity);
+    }
+}
+
 /**
  * @brief Frees the vector and all of its data structures.
  * @param v The vector to free.
  */
 static inline void CGS_VECTOR(free)(cgs_vec_name *v) {
-    free(v->array);
-    free(v);
+    CGS_VECTOR(destroy)(v);
+    cgs_vec_free(v->alloc_ctx, v, sizeof(cgs_vec_name));
 }
 
 #undef cgs_vec_type
 #undef cgs_vec_name
+#undef cgs_vec_integral
+#undef cgs_vec_floating
+#undef cgs_vec_pointer
+#undef cgs_vec_sum_type
+#undef cgs_vec_equals
+#undef cgs_vec_less
+#undef cgs_vec_inline_capacity
+#undef cgs_vec_mmap
+#undef CGS_VECTOR_ORDERED
+#undef CGS_VECTOR_SIMD_SEARCH
+#undef CGS_VECTOR_FLOATING
+#undef cgs_vec_malloc
+#undef cgs_vec_realloc
+#undef cgs_vec_free
 #endif /* include guard */
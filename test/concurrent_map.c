@@ -0,0 +1,103 @@
+#define _POSIX_C_SOURCE 200809L /* for pthread_rwlock_t in strict ISO C modes */
+#include <stdint.h>
+#include <pthread.h>
+
+#define cgs_map_key int64_t
+#define cgs_map_value int64_t
+#define cgs_map_default_hash
+#define cgs_map_default_value (-1)
+#define cgs_cmap_name llcmap
+#include "cgs_concurrent_map.h"
+#define cgs_llcmap 1
+
+#define cgs_map_key int
+#define cgs_map_value int
+#define cgs_map_default_hash
+#define cgs_map_pooled
+#define cgs_cmap_name iicmap
+#define cgs_cmap_shards 8
+#define cgs_cmap_spinlock
+#include "cgs_concurrent_map.h"
+#define cgs_iicmap 1
+
+#include "cnit/cnit_main.h"
+#define THREAD_COUNT 8
+#define TEST_COUNT 8192
+
+struct insert_args {
+    llcmap *map;
+    int64_t offset;
+};
+
+static void *insert_range(void *p) {
+    struct insert_args *args = p;
+    for (int64_t i = args->offset; i < args->offset + TEST_COUNT; i++) {
+        llcmap_insert(args->map, i, i * 2);
+    }
+    for (int64_t i = args->offset; i < args->offset + TEST_COUNT; i += 2) {
+        llcmap_erase(args->map, i);
+    }
+    return NULL;
+}
+
+int test_cmap_insert() {
+    llcmap *map = llcmap_new();
+    pthread_t threads[THREAD_COUNT];
+    struct insert_args args[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        args[i].map = map;
+        args[i].offset = (int64_t) i * TEST_COUNT;
+        pthread_create(&threads[i], NULL, insert_range, &args[i]);
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    CNIT_ASSERT(llcmap_size(map) == THREAD_COUNT * TEST_COUNT / 2);
+    for (int64_t i = 0; i < THREAD_COUNT * TEST_COUNT; i++) {
+        CNIT_ASSERT(llcmap_find(map, i) == (i % 2 ? i * 2 : -1));
+    }
+    llcmap_clear(map);
+    CNIT_ASSERT(llcmap_size(map) == 0);
+    CNIT_ASSERT(llcmap_find(map, 1) == -1);
+    llcmap_free(map);
+    return 0;
+}
+
+static int increment(int value, void *ctx) {
+    (void) ctx;
+    return value + 1;
+}
+
+static void *count_keys(void *p) {
+    iicmap *map = p;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        iicmap_upsert(map, i % 100, increment, NULL);
+    }
+    return NULL;
+}
+
+int test_cmap_upsert() {
+    iicmap *map = iicmap_new();
+    pthread_t threads[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_create(&threads[i], NULL, count_keys, map);
+    }
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    CNIT_ASSERT(iicmap_size(map) == 100);
+    int total = 0;
+    for (int i = 0; i < 100; i++) {
+        total += iicmap_find(map, i);
+    }
+    CNIT_ASSERT(total == THREAD_COUNT * TEST_COUNT);
+    CNIT_ASSERT(iicmap_find(map, 0) == THREAD_COUNT * ((TEST_COUNT + 99) / 100));
+    iicmap_free(map);
+    return 0;
+}
+
+int main() {
+    cnit_add_test(test_cmap_insert, "Concurrent map insert/find/erase operations");
+    cnit_add_test(test_cmap_upsert, "Concurrent map upsert");
+    return cnit_run_tests();
+}
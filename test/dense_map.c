@@ -0,0 +1,117 @@
+#include <stdint.h>
+
+#define cgs_map_key int
+#define cgs_map_value int
+#define cgs_map_default_hash
+#define cgs_map_default_value (-1)
+#define cgs_map_name iidmap
+#include "cgs_dense_map.h"
+#define cgs_iidmap 1
+
+#define cgs_map_key int64_t
+#define cgs_map_value int64_t
+#define cgs_map_name lldmap
+#define cgs_map_default_hash
+#define cgs_map_int_hash_identity
+#include "cgs_dense_map.h"
+#define cgs_lldmap 1
+
+#include "cnit/cnit_main.h"
+#define TEST_COUNT 8192
+
+int test_dense_map_insert() {
+    lldmap *map = lldmap_new();
+    for (int i = 0; i < TEST_COUNT; i++) {
+        lldmap_insert(map, (int64_t) i << 20, i);
+        CNIT_ASSERT(map->size == i + 1);
+    }
+    for (int i = 0; i < TEST_COUNT; i++) {
+        CNIT_ASSERT(lldmap_find(map, (int64_t) i << 20) == i);
+        CNIT_ASSERT(lldmap_find(map, ((int64_t) i << 20) + 1) == 0);
+    }
+    /* overwriting keeps the insertion order */
+    for (int i = 0; i < TEST_COUNT; i += 2) {
+        lldmap_insert(map, (int64_t) i << 20, -i);
+    }
+    CNIT_ASSERT(map->size == TEST_COUNT);
+    int64_t expected = 0;
+    cgs_dense_map_foreach(lldmap, map, k, v) {
+        CNIT_ASSERT(k == expected << 20);
+        CNIT_ASSERT(v == (expected % 2 ? expected : -expected));
+        expected++;
+    }
+    CNIT_ASSERT(expected == TEST_COUNT);
+    lldmap_free(map);
+    return 0;
+}
+
+int test_dense_map_erase() {
+    iidmap *map = iidmap_new();
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < TEST_COUNT; i++) {
+            iidmap_insert(map, i, i * 2);
+        }
+        for (int i = 0; i < TEST_COUNT; i += 3) {
+            CNIT_ASSERT(iidmap_erase(map, i) == i * 2);
+        }
+        CNIT_ASSERT(iidmap_erase(map, 0) == -1);
+        CNIT_ASSERT(map->entries.size > map->size);
+        for (int i = 0; i < TEST_COUNT; i++) {
+            CNIT_ASSERT(iidmap_find(map, i) == (i % 3 ? i * 2 : -1));
+        }
+        {
+            int prev = -1, count = 0;
+            cgs_dense_map_foreach(iidmap, map, k, v) {
+                CNIT_ASSERT(k > prev && k % 3 != 0 && v == k * 2);
+                prev = k;
+                count++;
+            }
+            CNIT_ASSERT(count == map->size);
+        }
+        iidmap_compact(map);
+        CNIT_ASSERT(map->entries.size == map->size);
+        for (int i = 0; i < TEST_COUNT; i++) {
+            CNIT_ASSERT(iidmap_find(map, i) == (i % 3 ? i * 2 : -1));
+        }
+
+        /* erasing most entries compacts the array on its own */
+        for (int i = 0; i < TEST_COUNT; i++) {
+            if (i % 3 && i % 10) {
+                CNIT_ASSERT(iidmap_erase(map, i) == i * 2);
+            }
+        }
+        CNIT_ASSERT(map->entries.size <= map->size * 2);
+        {
+            int count = 0;
+            cgs_dense_map_foreach(iidmap, map, k, v) {
+                CNIT_ASSERT(k % 10 == 0 && k % 3 != 0);
+                (void) v;
+                if (++count == 5) {
+                    break;
+                }
+            }
+            CNIT_ASSERT(count == 5);
+        }
+        iidmap_clear(map);
+        CNIT_ASSERT(map->size == 0);
+        CNIT_ASSERT(iidmap_find(map, 10) == -1);
+    }
+    iidmap_free(map);
+
+    iidmap embedded;
+    iidmap_init(&embedded, NULL);
+    iidmap_reserve(&embedded, TEST_COUNT);
+    size_t capacity = embedded.capacity;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        iidmap_insert(&embedded, i, i);
+    }
+    CNIT_ASSERT(embedded.capacity == capacity);
+    iidmap_destroy(&embedded);
+    return 0;
+}
+
+int main() {
+    cnit_add_test(test_dense_map_insert, "Dense map insert/find operations");
+    cnit_add_test(test_dense_map_erase, "Dense map erase/compaction");
+    return cnit_run_tests();
+}
@@ -0,0 +1,74 @@
+#define cgs_deque_type int
+#define cgs_deque_name ideque
+#include "cgs_deque.h"
+#define cgs_ideque 1
+
+#include "cnit/cnit_main.h"
+#define TEST_COUNT 1000
+
+int test_deque_ends() {
+    ideque *d = ideque_new();
+    /* 999, 997, ..., 1, 0, 2, ..., 998 */
+    for (int i = 0; i < TEST_COUNT; i++) {
+        if (i % 2) {
+            ideque_push_front(d, i);
+        } else {
+            ideque_push_back(d, i);
+        }
+        CNIT_ASSERT(d->size == i + 1);
+    }
+    for (int i = 0; i < TEST_COUNT / 2; i++) {
+        CNIT_ASSERT(ideque_at(d, i) == TEST_COUNT - 1 - 2 * i);
+        CNIT_ASSERT(ideque_at(d, TEST_COUNT / 2 + i) == 2 * i);
+    }
+    for (int i = TEST_COUNT - 1; i >= 0; i--) {
+        if (i % 2) {
+            CNIT_ASSERT(ideque_front(d) == i);
+            CNIT_ASSERT(ideque_pop_front(d) == i);
+        } else {
+            CNIT_ASSERT(ideque_back(d) == i);
+            CNIT_ASSERT(ideque_pop_back(d) == i);
+        }
+    }
+    CNIT_ASSERT(ideque_empty(d));
+    ideque_free(d);
+    return 0;
+}
+
+int test_deque_window() {
+    ideque *d = ideque_new();
+    /* a sliding window keeps the elements wrapped around, also while growing */
+    int next = 0, first = 0;
+    for (int round = 0; round < TEST_COUNT; round++) {
+        ideque_push_back(d, next++);
+        ideque_push_back(d, next++);
+        if (round % 3 != 0) {
+            CNIT_ASSERT(ideque_pop_front(d) == first++);
+        }
+        CNIT_ASSERT(d->size == next - first);
+        if (round % 100 == 0) {
+            size_t index = 0, n, segments = 0;
+            while (index < d->size) {
+                int *seg = ideque_segment(d, index, &n);
+                for (size_t i = 0; i < n; i++) {
+                    CNIT_ASSERT(seg[i] == first + (int) (index + i));
+                }
+                index += n;
+                segments++;
+            }
+            CNIT_ASSERT(segments <= 2);
+        }
+    }
+    ideque_set(d, 0, -1);
+    CNIT_ASSERT(ideque_front(d) == -1);
+    ideque_clear(d);
+    CNIT_ASSERT(ideque_empty(d));
+    ideque_free(d);
+    return 0;
+}
+
+int main() {
+    cnit_add_test(test_deque_ends, "Deque push/pop at both ends");
+    cnit_add_test(test_deque_window, "Deque sliding window and segments");
+    return cnit_run_tests();
+}
@@ -0,0 +1,102 @@
+#include <stdint.h>
+
+#define cgs_map_key int
+#define cgs_map_value int
+#define cgs_map_default_hash
+#define cgs_map_name iifmap
+#include "cgs_flatmap.h"
+#define cgs_iifmap 1
+
+#define cgs_map_key int64_t
+#define cgs_map_value int64_t
+#define cgs_map_name llfmap
+#define cgs_map_default_hash
+#define cgs_map_default_value (-1)
+#include "cgs_flatmap.h"
+#define cgs_llfmap 1
+
+#include "cnit/cnit_main.h"
+#define TEST_COUNT 8192
+
+int test_flatmap_insert() {
+    iifmap *map = iifmap_new();
+    for (int i = 0; i < TEST_COUNT; i++) {
+        iifmap_insert(map, i * i, i);
+        CNIT_ASSERT(map->size == i + 1);
+    }
+    CNIT_ASSERT(map->size < map->capacity);
+
+    int square = 0;
+    int sqrt = 0;
+    int delta = 1;
+    for (int i = 0; i < TEST_COUNT * TEST_COUNT; i++) {
+        if (i == square) {
+            CNIT_ASSERT(iifmap_find(map, i) == sqrt);
+            square += delta;
+            delta += 2;
+            sqrt++;
+        } else {
+            CNIT_ASSERT(iifmap_find(map, i) == 0);
+        }
+    }
+
+    /* overwrite existing values */
+    for (int i = 0; i < TEST_COUNT; i++) {
+        iifmap_insert(map, i * i, -i);
+    }
+    CNIT_ASSERT(map->size == TEST_COUNT);
+    for (int i = 0; i < TEST_COUNT; i++) {
+        CNIT_ASSERT(iifmap_find(map, i * i) == -i);
+    }
+    iifmap_free(map);
+    return 0;
+}
+
+int test_flatmap_erase() {
+    llfmap *map = llfmap_new();
+    for (int i = 0; i < TEST_COUNT * 5; i++) {
+        llfmap_insert(map, i * 6, i * 6 + 1);
+        CNIT_ASSERT(llfmap_find(map, i * 6) == i * 6 + 1);
+    }
+
+    for (int i = 0; i < TEST_COUNT * 2; i++) {
+        CNIT_ASSERT(llfmap_erase(map, i * 15) == (i % 2 == 0 ? i * 15 + 1 : -1));
+        CNIT_ASSERT(map->size == TEST_COUNT * 5 - (i / 2) - 1);
+    }
+
+    for (int i = 0; i < TEST_COUNT * 30; i++) {
+        CNIT_ASSERT(llfmap_find(map, i) == ((i % 6 == 0 && i % 15 != 0) ? i + 1 : -1));
+    }
+
+    llfmap_clear(map);
+    CNIT_ASSERT(map->size == 0);
+    CNIT_ASSERT(llfmap_find(map, 6) == -1);
+
+    llfmap_free(map);
+    return 0;
+}
+
+int test_flatmap_churn() {
+    /* repeated insert/erase cycles must reuse deleted slots instead of growing forever */
+    llfmap *map = llfmap_new();
+    for (int i = 0; i < TEST_COUNT * 8; i++) {
+        llfmap_insert(map, i, i);
+        if (i >= 64) {
+            CNIT_ASSERT(llfmap_erase(map, i - 64) == i - 64);
+        }
+    }
+    CNIT_ASSERT(map->size == 64);
+    CNIT_ASSERT(map->capacity <= 256);
+    for (int i = 0; i < TEST_COUNT * 8; i++) {
+        CNIT_ASSERT(llfmap_find(map, i) == (i >= TEST_COUNT * 8 - 64 ? i : -1));
+    }
+    llfmap_free(map);
+    return 0;
+}
+
+int main() {
+    cnit_add_test(test_flatmap_insert, "Flat map insert/find operations");
+    cnit_add_test(test_flatmap_erase, "Flat map insert/erase operations");
+    cnit_add_test(test_flatmap_churn, "Flat map insert/erase churn");
+    return cnit_run_tests();
+}
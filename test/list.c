@@ -5,6 +5,7 @@
 
 #define cgs_list_type int
 #define cgs_list_name ilist
+#define cgs_list_less(a, b) ((a) < (b))
 #include "cgs_list.h"
 #define cgs_ilist 1
 
@@ -18,6 +19,33 @@
 #include "cgs_list.h"
 #define cgs_slist 1
 
+#define cgs_list_type int
+#define cgs_list_name plist
+#define cgs_list_pooled
+#define cgs_list_pool_chunk_size 64
+#include "cgs_list.h"
+#define cgs_plist 1
+
+#include "cgs_list.h"
+struct task {
+    int id;
+    cgs_list_link by_queue;
+    cgs_list_link by_owner;
+};
+
+#define cgs_list_type struct task
+#define cgs_list_name qlist
+#define cgs_list_intrusive by_queue
+#include "cgs_list.h"
+#define cgs_qlist 1
+
+#define cgs_list_type struct task
+#define cgs_list_name olist
+#define cgs_list_intrusive by_owner
+#define cgs_list_less(a, b) ((a)->id % 10 < (b)->id % 10)
+#include "cgs_list.h"
+#define cgs_olist 1
+
 #include "cnit/cnit_main.h"
 #define TEST_COUNT 1000
 
@@ -133,10 +161,189 @@ int test_splice() {
     return 0;
 }
 
+int test_pooled() {
+    int arr[TEST_COUNT];
+    for (int i = 0; i < TEST_COUNT; i++) {
+        arr[i] = i;
+    }
+
+    plist *l0 = plist_new();
+    plist_append_array(l0, arr, TEST_COUNT);
+    plist_push_back_n(l0, 10, -1);
+    CNIT_ASSERT(l0->size == TEST_COUNT + 10);
+    {
+        int i = 0;
+        cgs_list_foreach(plist, l0, n, e) {
+            CNIT_ASSERT(e == (i < TEST_COUNT ? i : -1));
+            if (i % 2 == 0) {
+                plist_erase(l0, n);
+            }
+            i++;
+        }
+    }
+    CNIT_ASSERT(l0->size == TEST_COUNT / 2 + 5);
+    plist_clear(l0);
+    CNIT_ASSERT(l0->size == 0);
+    plist_push_back(l0, 7);
+    CNIT_ASSERT(plist_pop_front(l0) == 7);
+    plist_free(l0);
+
+    /* two lists sharing a pool */
+    plist_pool *pool = plist_pool_new();
+    plist *l1 = plist_new_with_pool(pool), *l2 = plist_new_with_pool(pool);
+    for (int i = 0; i < TEST_COUNT; i++) {
+        plist_push_back(l1, i);
+        plist_push_front(l2, i);
+    }
+    plist_splice_after(l1, plist_back_node(l1), l2);
+    CNIT_ASSERT(l1->size == 2 * TEST_COUNT);
+    CNIT_ASSERT(plist_back(l1) == 0);
+    plist_free(l2);
+    plist_free(l1);
+    plist_pool_free(pool);
+    return 0;
+}
+
+int test_embedded() {
+    /* lists inside an array of structs, without a header allocation each */
+    struct {
+        ilist edges;
+        plist pooled;
+    } nodes[10];
+    for (int i = 0; i < 10; i++) {
+        ilist_init(&nodes[i].edges, NULL);
+        plist_init(&nodes[i].pooled, NULL);
+        for (int j = 0; j < i; j++) {
+            ilist_push_back(&nodes[i].edges, j);
+            plist_push_front(&nodes[i].pooled, j);
+        }
+    }
+    for (int i = 0; i < 10; i++) {
+        CNIT_ASSERT(nodes[i].edges.size == i);
+        CNIT_ASSERT(nodes[i].pooled.size == i);
+        if (i > 0) {
+            CNIT_ASSERT(ilist_back(&nodes[i].edges) == i - 1);
+            CNIT_ASSERT(plist_front(&nodes[i].pooled) == i - 1);
+        }
+        ilist_destroy(&nodes[i].edges);
+        plist_destroy(&nodes[i].pooled);
+    }
+    return 0;
+}
+
+int test_intrusive() {
+    struct task tasks[TEST_COUNT];
+    qlist *queue = qlist_new();
+    olist even, odd;
+    olist_init(&even, NULL);
+    olist_init(&odd, NULL);
+    for (int i = 0; i < TEST_COUNT; i++) {
+        tasks[i].id = i;
+        qlist_push_back(queue, &tasks[i]);
+        olist_push_front(i % 2 ? &odd : &even, &tasks[i]);
+    }
+    CNIT_ASSERT(queue->size == TEST_COUNT);
+    CNIT_ASSERT(qlist_front(queue) == &tasks[0]);
+    CNIT_ASSERT(olist_front(&odd) == &tasks[TEST_COUNT - 1]);
+
+    /* unlinking from one list leaves the object in the others */
+    for (int i = 0; i < TEST_COUNT; i += 3) {
+        qlist_unlink(queue, &tasks[i]);
+    }
+    {
+        int i = 1;
+        cgs_list_foreach(qlist, queue, n, t) {
+            CNIT_ASSERT(t == &tasks[i]);
+            CNIT_ASSERT(qlist_node_of(t) == n);
+            i += i % 3 == 1 ? 1 : 2;
+        }
+        CNIT_ASSERT(i >= TEST_COUNT);
+    }
+    {
+        int i = 0;
+        cgs_list_foreach_r(olist, &even, n, t) {
+            CNIT_ASSERT(t->id == i);
+            i += 2;
+        }
+        CNIT_ASSERT(i == TEST_COUNT);
+    }
+
+    olist_splice_before(&even, olist_front_node(&even), &odd);
+    CNIT_ASSERT(even.size == TEST_COUNT);
+    CNIT_ASSERT(odd.size == 0);
+    CNIT_ASSERT(olist_pop_front(&even)->id == TEST_COUNT - 1);
+    CNIT_ASSERT(olist_pop_back(&even)->id == 0);
+
+    qlist_free(queue);
+    olist_destroy(&even);
+    olist_destroy(&odd);
+    return 0;
+}
+
+int test_sort() {
+    ilist *l1 = ilist_new(), *l2 = ilist_new();
+    unsigned x = 12345;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        x = x * 1103515245 + 12345;
+        ilist_push_back(i % 3 ? l1 : l2, (x >> 16) % 100);
+    }
+    ilist_sort(l1);
+    ilist_sort(l2);
+    ilist_merge(l1, l2);
+    CNIT_ASSERT(l1->size == TEST_COUNT);
+    CNIT_ASSERT(l2->size == 0);
+    {
+        int prev = -1;
+        size_t count = 0;
+        cgs_list_foreach(ilist, l1, n, e) {
+            CNIT_ASSERT(prev <= e);
+            CNIT_ASSERT(n->prev->next == n);
+            prev = e;
+            count++;
+        }
+        CNIT_ASSERT(count == TEST_COUNT);
+    }
+    CNIT_ASSERT(ilist_unique(l1) == TEST_COUNT - 100);
+    {
+        int i = 0;
+        cgs_list_foreach(ilist, l1, n, e) {
+            CNIT_ASSERT(e == i++);
+        }
+        CNIT_ASSERT(ilist_back_node(l1)->next == ilist_sentinel_node(l1));
+    }
+    ilist_free(l1);
+    ilist_free(l2);
+
+    /* the sort is stable: ties keep their original order */
+    struct task tasks[TEST_COUNT];
+    olist l;
+    olist_init(&l, NULL);
+    for (int i = TEST_COUNT - 1; i >= 0; i--) {
+        tasks[i].id = i;
+        olist_push_front(&l, &tasks[i]);
+    }
+    olist_sort(&l);
+    {
+        struct task *prev = NULL;
+        cgs_list_foreach(olist, &l, n, t) {
+            CNIT_ASSERT(prev == NULL || prev->id % 10 < t->id % 10 ||
+                        (prev->id % 10 == t->id % 10 && prev->id < t->id));
+            prev = t;
+        }
+        CNIT_ASSERT(prev == olist_back(&l));
+    }
+    olist_destroy(&l);
+    return 0;
+}
+
 int main() {
     cnit_add_test(test_sanity, "List sanity test");
     cnit_add_test(test_push_pop, "List push/pop");
     cnit_add_test(test_foreach, "List foreach");
     cnit_add_test(test_splice, "List splice");
+    cnit_add_test(test_pooled, "Pooled list operations");
+    cnit_add_test(test_embedded, "Embedded list init/destroy");
+    cnit_add_test(test_intrusive, "Intrusive list operations");
+    cnit_add_test(test_sort, "List sort/merge/unique");
     return cnit_run_tests();
 }
\ No newline at end of file
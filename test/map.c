@@ -23,6 +23,36 @@
 #include "cgs_map.h"
 #define cgs_llmap 1
 
+#define cgs_map_key int64_t
+#define cgs_map_value int64_t
+#define cgs_map_name plmap
+#define cgs_map_default_hash
+#define cgs_map_default_value (-1)
+#define cgs_map_pooled
+#define cgs_map_pool_chunk_size 100
+#define cgs_map_int_hash_fibonacci
+#include "cgs_map.h"
+#define cgs_plmap 1
+
+#define cgs_map_key int
+#define cgs_map_value int
+#define cgs_map_name cmap
+#define cgs_map_default_hash
+#define cgs_map_default_value (-1)
+#define cgs_map_compact
+#define cgs_map_int_hash_identity
+#include "cgs_map.h"
+#define cgs_cmap 1
+
+#define cgs_map_key int
+#define cgs_map_value int
+#define cgs_map_name shmap
+#define cgs_map_default_hash
+#define cgs_map_default_value (-1)
+#define cgs_map_min_load_factor 20
+#include "cgs_map.h"
+#define cgs_shmap 1
+
 #include "cnit/cnit_main.h"
 #define TEST_COUNT 8192
 
@@ -48,6 +78,36 @@ int test_hash() {
     CNIT_ASSERT(cgs_map_hash_str("hel") != cgs_map_hash_str("hell"));
     CNIT_ASSERT(cgs_map_hash_str("hell") != cgs_map_hash_str("hello"));
     CNIT_ASSERT(cgs_map_hash_str("hello") != cgs_map_hash_str("Hello"));
+
+    /* the 64-bit hash, with every length path */
+    char buf[128];
+    for (int i = 0; i < 128; i++) {
+        buf[i] = (char) ('a' + i % 26);
+    }
+    for (int len = 0; len < 100; len++) {
+        char *str = buf + len % 7; /* also test unaligned strings */
+        char saved = str[len];
+        str[len] = 0;
+        CNIT_ASSERT(cgs_map_hash_strlen(str) == len);
+        CNIT_ASSERT(cgs_map_hash_str64(str) == cgs_map_hash64(str, len));
+        CNIT_ASSERT(cgs_map_hash64(str, len) != cgs_map_hash64(str, len + 1));
+        str[len] = saved;
+    }
+    CNIT_ASSERT(cgs_map_hash_str64("hello") != cgs_map_hash_str64("Hello"));
+
+    /* integer keys */
+    for (int i = 0; i < HIST_SIZE; i++) {
+        histogram[i] = 0;
+    }
+    for (int64_t i = 0; i < TEST_COUNT; i++) {
+        histogram[cgs_map_hash_int_mix(i << 32) % HIST_SIZE]++;
+        CNIT_ASSERT(cgs_map_hash_int_fibonacci(i) != cgs_map_hash_int_fibonacci(i + 1));
+        CNIT_ASSERT(iimap_hash((int) i) == cgs_map_hash_int_mix((uint32_t) i));
+    }
+    for (int i = 0; i < HIST_SIZE; i++) {
+        CNIT_ASSERT(histogram[i] < 2 * TEST_COUNT / HIST_SIZE);
+        CNIT_ASSERT(histogram[i] > TEST_COUNT / 2 / HIST_SIZE);
+    }
     return 0;
 }
 
@@ -95,9 +155,289 @@ int test_map_erase() {
     return 0;
 }
 
+int test_pooled_map() {
+    plmap *map = plmap_new();
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < TEST_COUNT; i++) {
+            plmap_insert(map, i, i * 2);
+        }
+        /* erase and reinsert to exercise entry recycling */
+        for (int i = 0; i < TEST_COUNT; i += 3) {
+            CNIT_ASSERT(plmap_erase(map, i) == i * 2);
+        }
+        for (int i = 0; i < TEST_COUNT; i += 6) {
+            plmap_insert(map, i, i * 3);
+        }
+        for (int i = 0; i < TEST_COUNT; i++) {
+            int64_t expected = i % 6 == 0 ? i * 3 : (i % 3 == 0 ? -1 : i * 2);
+            CNIT_ASSERT(plmap_find(map, i) == expected);
+        }
+        plmap_clear(map);
+        CNIT_ASSERT(map->size == 0);
+        CNIT_ASSERT(plmap_find(map, 1) == -1);
+    }
+    plmap_free(map);
+    return 0;
+}
+
+int test_map_bulk() {
+    static int64_t keys[TEST_COUNT], values[TEST_COUNT];
+    llmap *map = llmap_new();
+    for (int i = 0; i < 100; i++) {
+        llmap_insert(map, -i - 1, i);
+    }
+    llmap_reserve(map, TEST_COUNT * 2);
+    size_t buckets = map->vec.size;
+    for (int i = 0; i < 100; i++) {
+        CNIT_ASSERT(llmap_find(map, -i - 1) == i);
+    }
+
+    for (int i = 0; i < TEST_COUNT; i++) {
+        keys[i] = i % (TEST_COUNT / 2); /* every key appears twice */
+        values[i] = i;
+    }
+    llmap_insert_bulk(map, keys, values, TEST_COUNT);
+    CNIT_ASSERT(map->size == 100 + TEST_COUNT / 2);
+    CNIT_ASSERT(map->vec.size == buckets);
+    for (int i = 0; i < TEST_COUNT / 2; i++) {
+        CNIT_ASSERT(llmap_find(map, i) == i + TEST_COUNT / 2);
+    }
+
+    plmap *pmap = plmap_new();
+    plmap_insert_bulk(pmap, keys, values, TEST_COUNT);
+    for (int i = 0; i < TEST_COUNT / 2; i++) {
+        CNIT_ASSERT(plmap_find(pmap, i) == i + TEST_COUNT / 2);
+    }
+    plmap_free(pmap);
+    llmap_free(map);
+    return 0;
+}
+
+int test_compact_map() {
+    cmap *map = cmap_new();
+    CNIT_ASSERT(sizeof(cmap_entry) < sizeof(iimap_entry));
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < TEST_COUNT; i++) {
+            cmap_insert(map, i * 7, i);
+        }
+        for (int i = 0; i < TEST_COUNT; i += 2) {
+            CNIT_ASSERT(cmap_erase(map, i * 7) == i);
+        }
+        CNIT_ASSERT(map->size == TEST_COUNT / 2);
+        for (int i = 0; i < TEST_COUNT * 7; i++) {
+            CNIT_ASSERT(cmap_find(map, i) == ((i % 14 == 7) ? i / 7 : -1));
+        }
+        cmap_clear(map);
+        CNIT_ASSERT(cmap_find(map, 7) == -1);
+    }
+    cmap_free(map);
+    return 0;
+}
+
+int test_embedded_map() {
+    iimap maps[4];
+    for (int i = 0; i < 4; i++) {
+        iimap_init(&maps[i], NULL);
+        for (int j = 0; j < TEST_COUNT; j++) {
+            iimap_insert(&maps[i], j, i * j);
+        }
+    }
+    for (int i = 0; i < 4; i++) {
+        CNIT_ASSERT(maps[i].size == TEST_COUNT);
+        for (int j = 0; j < TEST_COUNT; j++) {
+            CNIT_ASSERT(iimap_find(&maps[i], j) == i * j);
+        }
+        iimap_destroy(&maps[i]);
+    }
+    plmap pooled;
+    plmap_init(&pooled, NULL);
+    plmap_insert(&pooled, 1, 2);
+    CNIT_ASSERT(plmap_find(&pooled, 1) == 2);
+    plmap_destroy(&pooled);
+    return 0;
+}
+
+int test_map_iteration() {
+    iimap *map = iimap_new();
+    plmap *pmap = plmap_new();
+    cmap *compact = cmap_new();
+    for (int i = 0; i < TEST_COUNT; i++) {
+        iimap_insert(map, i, i + 1);
+        plmap_insert(pmap, i, i + 1);
+        cmap_insert(compact, i, i + 1);
+    }
+    for (int i = 0; i < TEST_COUNT; i += 2) {
+        iimap_erase(map, i);
+        plmap_erase(pmap, i);
+        cmap_erase(compact, i);
+    }
+    /* recycles some of the erased pool slots */
+    for (int i = 0; i < TEST_COUNT; i += 4) {
+        plmap_insert(pmap, i, i + 1);
+    }
+
+    {
+        /* insertion order */
+        int expected = 1;
+        cgs_map_foreach(iimap, map, k, v) {
+            CNIT_ASSERT(k == expected && v == k + 1);
+            expected += 2;
+        }
+        CNIT_ASSERT(expected == TEST_COUNT + 1);
+    }
+    {
+        int64_t count = 0, sum = 0;
+        cgs_map_foreach(plmap, pmap, k, v) {
+            CNIT_ASSERT(k % 2 == 1 || k % 4 == 0);
+            CNIT_ASSERT(v == k + 1);
+            count++;
+            sum += k;
+        }
+        CNIT_ASSERT(count == pmap->size);
+        CNIT_ASSERT(sum == (int64_t) TEST_COUNT * TEST_COUNT * 3 / 8 - TEST_COUNT / 2);
+    }
+    {
+        size_t count = 0;
+        cmap_iter it;
+        for (cmap_entry *e = cmap_begin(compact, &it); e != NULL; e = cmap_next(compact, &it)) {
+            CNIT_ASSERT(e->key % 2 == 1 && e->value == e->key + 1);
+            CNIT_ASSERT(e == it.entry);
+            count++;
+        }
+        CNIT_ASSERT(count == TEST_COUNT / 2);
+    }
+    {
+        int count = 0;
+        cgs_map_foreach(cmap, compact, k, v) {
+            (void) k;
+            if (v == 2) {
+                continue;
+            }
+            if (++count == 10) {
+                break;
+            }
+        }
+        CNIT_ASSERT(count == 10);
+    }
+
+    plmap_clear(pmap);
+    iimap_clear(map);
+    cgs_map_foreach(plmap, pmap, k, v) {
+        (void) k, (void) v;
+        CNIT_ASSERT(0);
+    }
+    cgs_map_foreach(iimap, map, k, v) {
+        (void) k, (void) v;
+        CNIT_ASSERT(0);
+    }
+    cmap_free(compact);
+    plmap_free(pmap);
+    iimap_free(map);
+    return 0;
+}
+
+int test_map_reset() {
+    iimap *map = iimap_new();
+    cmap *compact = cmap_new();
+    plmap *pmap = plmap_new();
+    for (int round = 0; round < 3; round++) {
+        for (int i = 0; i < TEST_COUNT; i++) {
+            iimap_insert(map, i + round, i);
+            cmap_insert(compact, i + round, i);
+            plmap_insert(pmap, i + round, i);
+        }
+        size_t buckets = map->vec.size, hash_base = map->hash_base, split_index = map->split_index;
+        iimap_reset(map);
+        cmap_reset(compact);
+        plmap_reset(pmap);
+        CNIT_ASSERT(map->size == 0 && compact->size == 0 && pmap->size == 0);
+        CNIT_ASSERT(map->vec.size == buckets);
+        CNIT_ASSERT(map->hash_base == hash_base && map->split_index == split_index);
+        CNIT_ASSERT(map->free_list != NULL && compact->free_list != NULL);
+        CNIT_ASSERT(iimap_find(map, 1 + round) == 0);
+        CNIT_ASSERT(cmap_find(compact, 1 + round) == -1);
+        CNIT_ASSERT(plmap_find(pmap, 1 + round) == -1);
+        cgs_map_foreach(iimap, map, k, v) {
+            (void) k, (void) v;
+            CNIT_ASSERT(0);
+        }
+
+        /* refilling reuses every entry, and splits no buckets */
+        for (int i = 0; i < TEST_COUNT; i++) {
+            iimap_insert(map, i, -i);
+            cmap_insert(compact, i, -i);
+        }
+        CNIT_ASSERT(map->free_list == NULL && compact->free_list == NULL);
+        CNIT_ASSERT(map->vec.size == buckets);
+        for (int i = 0; i < TEST_COUNT; i++) {
+            CNIT_ASSERT(iimap_find(map, i) == -i);
+            CNIT_ASSERT(cmap_find(compact, i) == -i);
+        }
+        iimap_reset(map);
+        cmap_reset(compact);
+    }
+    plmap_free(pmap);
+    cmap_free(compact);
+    iimap_free(map);
+    return 0;
+}
+
+int test_map_shrink() {
+    shmap *map = shmap_new();
+    iimap *grown = iimap_new();
+    for (int round = 0; round < 2; round++) {
+        for (int i = 0; i < TEST_COUNT * 4; i++) {
+            shmap_insert(map, i, i);
+            iimap_insert(grown, i, i);
+        }
+        size_t peak = map->vec.size;
+        /* erasing merges buckets as the load factor drops */
+        for (int i = 0; i < TEST_COUNT * 4; i++) {
+            if (i % 64) {
+                CNIT_ASSERT(shmap_erase(map, i) == i);
+            }
+        }
+        CNIT_ASSERT(map->vec.size < peak / 8);
+        CNIT_ASSERT(map->size * 100 >= map->vec.size * 20);
+        for (int i = 0; i < TEST_COUNT * 4; i++) {
+            CNIT_ASSERT(shmap_find(map, i) == (i % 64 ? -1 : i));
+        }
+    }
+    for (int i = 0; i < TEST_COUNT * 4; i++) {
+        shmap_erase(map, i);
+    }
+    CNIT_ASSERT(map->vec.size == 16 && map->hash_base == 16 && map->split_index == 0);
+
+    /* without a minimum load factor, only shrink_to_fit merges buckets */
+    size_t peak = grown->vec.size;
+    for (int i = 0; i < TEST_COUNT * 4; i++) {
+        if (i % 16) {
+            iimap_erase(grown, i);
+        }
+    }
+    CNIT_ASSERT(grown->vec.size == peak);
+    iimap_shrink_to_fit(grown);
+    CNIT_ASSERT(grown->vec.size == grown->size * 2 && grown->vec.capacity == grown->vec.size);
+    for (int i = 0; i < TEST_COUNT * 4; i++) {
+        CNIT_ASSERT(iimap_find(grown, i) == (i % 16 ? 0 : i));
+    }
+    iimap_insert(grown, -1, 1);
+    CNIT_ASSERT(iimap_find(grown, -1) == 1);
+    iimap_free(grown);
+    shmap_free(map);
+    return 0;
+}
+
 int main() {
     cnit_add_test(test_hash, "Hashing functions");
     cnit_add_test(test_map_insert, "Map insert/find operations");
     cnit_add_test(test_map_erase, "Map insert/erase operations");
+    cnit_add_test(test_pooled_map, "Pooled map operations");
+    cnit_add_test(test_map_bulk, "Map reserve/bulk insert");
+    cnit_add_test(test_compact_map, "Compact map operations");
+    cnit_add_test(test_embedded_map, "Embedded map init/destroy");
+    cnit_add_test(test_map_iteration, "Map iteration");
+    cnit_add_test(test_map_reset, "Map reset with reuse");
+    cnit_add_test(test_map_shrink, "Map bucket merging and shrink_to_fit");
     return cnit_run_tests();
 }
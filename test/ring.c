@@ -0,0 +1,159 @@
+#define _POSIX_C_SOURCE 200809L /* for pthreads in strict ISO C modes */
+#include <stdint.h>
+#include <pthread.h>
+
+#define cgs_ring_type int
+#define cgs_ring_name iring
+#include "cgs_ring.h"
+#define cgs_iring 1
+
+#define cgs_ring_type int64_t
+#define cgs_ring_name spsc_ring
+#define cgs_ring_spsc
+#include "cgs_ring.h"
+#define cgs_spsc_ring 1
+
+#define cgs_ring_type int64_t
+#define cgs_ring_name mpmc_ring
+#define cgs_ring_mpmc
+#include "cgs_ring.h"
+#define cgs_mpmc_ring 1
+
+#include "cnit/cnit_main.h"
+#define TEST_COUNT 20000
+#define THREAD_COUNT 4
+
+int test_ring() {
+    iring *r = iring_new(100);
+    CNIT_ASSERT(iring_capacity(r) == 128);
+    CNIT_ASSERT(iring_empty(r));
+    int next_push = 0, next_pop = 0, e;
+    /* push and pop in uneven batches, so that the positions wrap around many times */
+    for (int round = 0; round < 1000; round++) {
+        for (int i = 0; i < 7; i++) {
+            if (iring_push(r, next_push)) {
+                next_push++;
+            }
+        }
+        CNIT_ASSERT(iring_size(r) == next_push - next_pop);
+        if (round % 3 == 0) {
+            CNIT_ASSERT(iring_pop(r, &e));
+            CNIT_ASSERT(e == next_pop++);
+        }
+        if (round % 50 == 49) {
+            int arr[128];
+            size_t n = iring_pop_n(r, arr, 128);
+            CNIT_ASSERT(n == next_push - next_pop);
+            for (size_t i = 0; i < n; i++) {
+                CNIT_ASSERT(arr[i] == next_pop++);
+            }
+            CNIT_ASSERT(iring_empty(r));
+            CNIT_ASSERT(!iring_pop(r, &e));
+        }
+    }
+    int arr[200];
+    for (int i = 0; i < 200; i++) {
+        arr[i] = i;
+    }
+    iring_pop_n(r, arr + 100, 100);
+    CNIT_ASSERT(iring_push_n(r, arr, 200) == 128);
+    CNIT_ASSERT(!iring_push(r, 0));
+    CNIT_ASSERT(iring_pop_n(r, arr, 200) == 128);
+    for (int i = 0; i < 128; i++) {
+        CNIT_ASSERT(arr[i] == i);
+    }
+    iring_free(r);
+    return 0;
+}
+
+static void *spsc_produce(void *p) {
+    spsc_ring *r = p;
+    int64_t batch[16];
+    int64_t next = 0;
+    while (next < TEST_COUNT) {
+        size_t n = 0;
+        while (n < 16 && next + n < TEST_COUNT) {
+            batch[n] = next + n;
+            n++;
+        }
+        next += spsc_ring_push_n(r, batch, n);
+    }
+    return NULL;
+}
+
+int test_spsc_ring() {
+    spsc_ring *r = spsc_ring_new(64);
+    pthread_t producer;
+    pthread_create(&producer, NULL, spsc_produce, r);
+    int64_t expected = 0, e;
+    while (expected < TEST_COUNT) {
+        if (spsc_ring_pop(r, &e)) {
+            CNIT_ASSERT(e == expected);
+            expected++;
+        }
+    }
+    pthread_join(producer, NULL);
+    CNIT_ASSERT(spsc_ring_empty(r));
+    spsc_ring_free(r);
+    return 0;
+}
+
+struct mpmc_args {
+    mpmc_ring *r;
+    int64_t offset, sum;
+};
+
+static void *mpmc_produce(void *p) {
+    struct mpmc_args *args = p;
+    for (int64_t i = 0; i < TEST_COUNT; i++) {
+        while (!mpmc_ring_push(args->r, args->offset + i)) {
+        }
+    }
+    return NULL;
+}
+
+static void *mpmc_consume(void *p) {
+    struct mpmc_args *args = p;
+    int64_t batch[8];
+    int64_t count = 0;
+    /* every consumer takes the same share of the elements */
+    while (count < TEST_COUNT) {
+        size_t want = TEST_COUNT - count < 8 ? TEST_COUNT - count : 8;
+        size_t n = mpmc_ring_pop_n(args->r, batch, want);
+        for (size_t i = 0; i < n; i++) {
+            args->sum += batch[i];
+        }
+        count += n;
+    }
+    return NULL;
+}
+
+int test_mpmc_ring() {
+    mpmc_ring *r = mpmc_ring_new(256);
+    pthread_t producers[THREAD_COUNT], consumers[THREAD_COUNT];
+    struct mpmc_args producer_args[THREAD_COUNT], consumer_args[THREAD_COUNT];
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        producer_args[i] = (struct mpmc_args) { r, (int64_t) i * TEST_COUNT, 0 };
+        consumer_args[i] = (struct mpmc_args) { r, 0, 0 };
+        pthread_create(&producers[i], NULL, mpmc_produce, &producer_args[i]);
+        pthread_create(&consumers[i], NULL, mpmc_consume, &consumer_args[i]);
+    }
+    int64_t sum = 0;
+    for (int i = 0; i < THREAD_COUNT; i++) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumers[i], NULL);
+        sum += consumer_args[i].sum;
+    }
+    int64_t total = (int64_t) THREAD_COUNT * TEST_COUNT;
+    CNIT_ASSERT(sum == total * (total - 1) / 2);
+    CNIT_ASSERT(mpmc_ring_empty(r));
+    mpmc_ring_free(r);
+    return 0;
+}
+
+int main() {
+    cnit_add_test(test_ring, "Ring push/pop operations");
+    cnit_add_test(test_spsc_ring, "Single producer single consumer ring");
+    cnit_add_test(test_mpmc_ring, "Multi producer multi consumer ring");
+    return cnit_run_tests();
+}
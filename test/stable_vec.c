@@ -0,0 +1,95 @@
+#include <stdint.h>
+
+#define cgs_svec_type int
+#define cgs_svec_name isvec
+#include "cgs_stable_vec.h"
+#define cgs_isvec 1
+
+struct record {
+    int64_t id;
+    double score;
+};
+
+#define cgs_svec_type struct record
+#define cgs_svec_name rsvec
+#define cgs_svec_first_segment 4
+#include "cgs_stable_vec.h"
+#define cgs_rsvec 1
+
+#include "cnit/cnit_main.h"
+#define TEST_COUNT 100000
+
+int test_stable_vec_push_pop() {
+    rsvec *v = rsvec_new();
+    struct record *first = NULL, *hundredth = NULL;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        struct record r = {i, i * 0.5};
+        rsvec_push_back(v, r);
+        if (i == 0) {
+            first = rsvec_ptr(v, 0);
+        } else if (i == 100) {
+            hundredth = rsvec_ptr(v, 100);
+        }
+        CNIT_ASSERT(v->size == i + 1);
+    }
+    /* growing never moved the elements */
+    CNIT_ASSERT(rsvec_ptr(v, 0) == first && first->id == 0);
+    CNIT_ASSERT(rsvec_ptr(v, 100) == hundredth && hundredth->id == 100);
+    for (int i = 0; i < TEST_COUNT; i++) {
+        CNIT_ASSERT(rsvec_at(v, i).id == i);
+    }
+    for (int i = TEST_COUNT - 1; i >= TEST_COUNT / 2; i--) {
+        CNIT_ASSERT(rsvec_pop_back(v).id == i);
+    }
+    CNIT_ASSERT(rsvec_back(v).id == TEST_COUNT / 2 - 1);
+    size_t capacity = v->capacity;
+    rsvec_shrink_to_fit(v);
+    CNIT_ASSERT(v->capacity < capacity && v->capacity >= v->size);
+    CNIT_ASSERT(rsvec_ptr(v, 100) == hundredth);
+    rsvec_free(v);
+    return 0;
+}
+
+int test_stable_vec_segments() {
+    static int arr[TEST_COUNT];
+    for (int i = 0; i < TEST_COUNT; i++) {
+        arr[i] = i;
+    }
+    isvec v;
+    isvec_init(&v, NULL);
+    isvec_push_back(&v, -1);
+    isvec_append_array(&v, arr, TEST_COUNT);
+    isvec_set(&v, 0, 7);
+    CNIT_ASSERT(v.size == TEST_COUNT + 1);
+
+    /* visit the vector one contiguous run at a time */
+    size_t index = 0, runs = 0, n;
+    int64_t sum = 0;
+    while (index < v.size) {
+        int *run = isvec_segment(&v, index, &n);
+        CNIT_ASSERT(n > 0);
+        for (size_t i = 0; i < n; i++) {
+            CNIT_ASSERT(run[i] == (index + i == 0 ? 7 : (int) (index + i - 1)));
+            sum += run[i];
+        }
+        index += n;
+        runs++;
+    }
+    CNIT_ASSERT(index == v.size);
+    CNIT_ASSERT(runs == v.segment_count);
+    CNIT_ASSERT(sum == (int64_t) TEST_COUNT * (TEST_COUNT - 1) / 2 + 7);
+
+    isvec_clear(&v);
+    CNIT_ASSERT(isvec_empty(&v));
+    isvec_reserve(&v, 1000);
+    CNIT_ASSERT(v.capacity >= 1000);
+    isvec_destroy(&v);
+    CNIT_ASSERT(v.segment_count == 0 && v.capacity == 0);
+    return 0;
+}
+
+int main() {
+    cnit_add_test(test_stable_vec_push_pop, "Stable vector push/pop and address stability");
+    cnit_add_test(test_stable_vec_segments, "Stable vector segment iteration");
+    return cnit_run_tests();
+}
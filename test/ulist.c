@@ -0,0 +1,93 @@
+#define cgs_ulist_type int
+#define cgs_ulist_name iulist
+#include "cgs_ulist.h"
+#define cgs_iulist 1
+
+#define cgs_ulist_type double
+#define cgs_ulist_name dulist
+#define cgs_ulist_node_capacity 3
+#include "cgs_ulist.h"
+#define cgs_dulist 1
+
+#include "cnit/cnit_main.h"
+#define TEST_COUNT 1000
+
+int test_ulist_push_pop() {
+    dulist *l = dulist_new();
+    /* TEST_COUNT - 1, ..., 3, 1, 0, 2, 4, ..., TEST_COUNT - 2 */
+    for (int i = 0; i < TEST_COUNT; i++) {
+        if (i % 2) {
+            dulist_push_front(l, i);
+        } else {
+            dulist_push_back(l, i);
+        }
+        CNIT_ASSERT(l->size == i + 1);
+    }
+    int count = 0;
+    cgs_ulist_foreach(dulist, l, n, e) {
+        int expected = count < TEST_COUNT / 2 ? TEST_COUNT - 1 - 2 * count : 2 * (count - TEST_COUNT / 2);
+        CNIT_ASSERT(e == expected);
+        count++;
+    }
+    CNIT_ASSERT(count == TEST_COUNT);
+    for (int i = TEST_COUNT - 1; i >= 0; i--) {
+        if (i % 2) {
+            CNIT_ASSERT(dulist_front(l) == i);
+            CNIT_ASSERT(dulist_pop_front(l) == i);
+        } else {
+            CNIT_ASSERT(dulist_back(l) == i);
+            CNIT_ASSERT(dulist_pop_back(l) == i);
+        }
+    }
+    CNIT_ASSERT(dulist_empty(l));
+    CNIT_ASSERT(dulist_front_node(l) == NULL);
+    cgs_ulist_foreach(dulist, l, n, e) {
+        (void) e;
+        CNIT_ASSERT(0);
+    }
+    dulist_free(l);
+    return 0;
+}
+
+int test_ulist_bulk() {
+    int arr[TEST_COUNT];
+    for (int i = 0; i < TEST_COUNT; i++) {
+        arr[i] = i;
+    }
+    iulist *l1 = iulist_new();
+    iulist l2;
+    iulist_init(&l2, NULL);
+    iulist_push_back(l1, -1);
+    iulist_append_array(l1, arr, TEST_COUNT);
+    iulist_append_array(&l2, arr, TEST_COUNT);
+    iulist_splice(l1, &l2);
+    CNIT_ASSERT(l1->size == 2 * TEST_COUNT + 1);
+    CNIT_ASSERT(iulist_empty(&l2));
+    int i = -1;
+    cgs_ulist_foreach(iulist, l1, n, e) {
+        CNIT_ASSERT(e == (i < TEST_COUNT ? i : i - TEST_COUNT));
+        i++;
+    }
+    CNIT_ASSERT(i == 2 * TEST_COUNT);
+    /* break leaves the whole loop, continue only skips an element */
+    i = 0;
+    cgs_ulist_foreach(iulist, l1, n, e) {
+        if (e < 10) {
+            continue;
+        }
+        if (e == 500) {
+            break;
+        }
+        i++;
+    }
+    CNIT_ASSERT(i == 490);
+    iulist_free(l1);
+    iulist_destroy(&l2);
+    return 0;
+}
+
+int main() {
+    cnit_add_test(test_ulist_push_pop, "Unrolled list push/pop operations");
+    cnit_add_test(test_ulist_bulk, "Unrolled list append/splice/iteration");
+    return cnit_run_tests();
+}
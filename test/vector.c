@@ -1,10 +1,12 @@
 #define cgs_vec_type double
 #define cgs_vec_name dvec
+#define cgs_vec_floating
 #include "cgs_vector.h"
 #define cgs_dvec 1
 
 #define cgs_vec_type int
 #define cgs_vec_name ivec
+#define cgs_vec_integral
 #include "cgs_vector.h"
 #define cgs_ivec 1
 
@@ -13,6 +15,73 @@
 #include "cgs_vector.h"
 #define cgs_svec 1
 
+#include <stdlib.h>
+#include <stdint.h>
+
+#define cgs_vec_type uint8_t
+#define cgs_vec_name bvec
+#define cgs_vec_integral
+#define cgs_vec_sum_type long
+#include "cgs_vector.h"
+#define cgs_bvec 1
+
+#define cgs_vec_type int64_t
+#define cgs_vec_name lvec
+#define cgs_vec_integral
+#include "cgs_vector.h"
+#define cgs_lvec 1
+
+#define cgs_vec_type float
+#define cgs_vec_name fvec
+#define cgs_vec_floating
+#include "cgs_vector.h"
+#define cgs_fvec 1
+
+struct point {
+    int x, y;
+};
+
+#define cgs_vec_type struct point
+#define cgs_vec_name ptvec
+#define cgs_vec_equals(a, b) ((a).x == (b).x && (a).y == (b).y)
+#define cgs_vec_less(a, b) ((a).x < (b).x || ((a).x == (b).x && (a).y < (b).y))
+#include "cgs_vector.h"
+#define cgs_ptvec 1
+
+/* Allocator that counts live bytes in its context */
+static void *counting_malloc(size_t *live, size_t size) {
+    *live += size;
+    return malloc(size);
+}
+
+static void *counting_realloc(size_t *live, void *ptr, size_t old_size, size_t size) {
+    *live += size - old_size;
+    return realloc(ptr, size);
+}
+
+static void counting_free(size_t *live, void *ptr, size_t size) {
+    *live -= size;
+    free(ptr);
+}
+
+#define cgs_vec_type long
+#define cgs_vec_name cvec
+#define cgs_vec_malloc(ctx, size) counting_malloc(ctx, size)
+#define cgs_vec_realloc(ctx, ptr, old_size, size) counting_realloc(ctx, ptr, old_size, size)
+#define cgs_vec_free(ctx, ptr, size) counting_free(ctx, ptr, size)
+#include "cgs_vector.h"
+#define cgs_cvec 1
+
+#define cgs_vec_type int
+#define cgs_vec_name smallvec
+#define cgs_vec_integral
+#define cgs_vec_inline_capacity 4
+#define cgs_vec_malloc(ctx, size) counting_malloc(ctx, size)
+#define cgs_vec_realloc(ctx, ptr, old_size, size) counting_realloc(ctx, ptr, old_size, size)
+#define cgs_vec_free(ctx, ptr, size) counting_free(ctx, ptr, size)
+#include "cgs_vector.h"
+#define cgs_smallvec 1
+
 #include "cnit/cnit_main.h"
 #define TEST_COUNT 1000
 
@@ -81,9 +150,325 @@ int test_insert_erase() {
     return 0;
 }
 
+int test_allocator_hooks() {
+    size_t live = 0;
+    cvec *v = cvec_new_with_ctx(&live);
+    CNIT_ASSERT(v->alloc_ctx == &live);
+    CNIT_ASSERT(live == sizeof(cvec) + v->capacity * sizeof(long));
+    for (int i = 0; i < TEST_COUNT; i++) {
+        cvec_push_back(v, i);
+    }
+    CNIT_ASSERT(live == sizeof(cvec) + v->capacity * sizeof(long));
+    cvec_free(v);
+    CNIT_ASSERT(live == 0);
+    return 0;
+}
+
+int test_search() {
+    bvec *b = bvec_new();
+    lvec *l = lvec_new();
+    fvec *f = fvec_new();
+    ptvec *pt = ptvec_new();
+    /* every length up to a few vector widths, with the match in every position */
+    for (int n = 0; n < 150; n++) {
+        for (int pos = -1; pos < n; pos++) {
+            bvec_clear(b);
+            lvec_clear(l);
+            fvec_clear(f);
+            ptvec_clear(pt);
+            for (int i = 0; i < n; i++) {
+                int value = i == pos || i == n - 1 - pos ? 7 : 1;
+                bvec_push_back(b, (uint8_t) value);
+                lvec_push_back(l, i == pos || i == n - 1 - pos ? INT64_C(7) << 40 : 7);
+                fvec_push_back(f, (float) value);
+                ptvec_push_back(pt, (struct point) { value, 0 });
+            }
+            size_t first = pos < 0 ? (size_t) -1 : (size_t) (pos < n - 1 - pos ? pos : n - 1 - pos);
+            size_t last = pos < 0 ? (size_t) -1 : (size_t) (pos > n - 1 - pos ? pos : n - 1 - pos);
+            size_t count = pos < 0 ? 0 : pos == n - 1 - pos ? 1 : 2;
+            CNIT_ASSERT(bvec_find(b, 7) == first);
+            CNIT_ASSERT(bvec_rfind(b, 7) == last);
+            CNIT_ASSERT(bvec_count(b, 7) == count);
+            CNIT_ASSERT(lvec_find(l, INT64_C(7) << 40) == first);
+            CNIT_ASSERT(lvec_rfind(l, INT64_C(7) << 40) == last);
+            CNIT_ASSERT(lvec_count(l, INT64_C(7) << 40) == count);
+            CNIT_ASSERT(fvec_find(f, 7.0f) == first);
+            CNIT_ASSERT(fvec_rfind(f, 7.0f) == last);
+            CNIT_ASSERT(fvec_count(f, 7.0f) == count);
+            CNIT_ASSERT(ptvec_find(pt, (struct point) { 7, 0 }) == first);
+            CNIT_ASSERT(ptvec_rfind(pt, (struct point) { 7, 0 }) == last);
+            CNIT_ASSERT(ptvec_count(pt, (struct point) { 7, 0 }) == count);
+            CNIT_ASSERT(bvec_contains(b, 7) == (pos >= 0));
+            CNIT_ASSERT(!lvec_contains(l, 7 << 20));
+        }
+    }
+    /* floating-point elements are compared by value, not by bits */
+    fvec_push_back(f, -0.0f);
+    CNIT_ASSERT(fvec_find(f, 0.0f) == f->size - 1);
+    bvec_free(b);
+    lvec_free(l);
+    fvec_free(f);
+    ptvec_free(pt);
+    return 0;
+}
+
+int test_reductions() {
+    bvec *b = bvec_new();
+    dvec *d = dvec_new();
+    for (int i = 0; i < TEST_COUNT; i++) {
+        bvec_push_back(b, (uint8_t) (i * 37 % 251));
+        dvec_push_back(d, (i * 37 % 1001) - 500.5);
+    }
+    CNIT_ASSERT(bvec_min(b) == 0);
+    CNIT_ASSERT(bvec_max(b) == 250);
+    long sum = 0;
+    for (int i = 0; i < TEST_COUNT; i++) {
+        sum += i * 37 % 251;
+    }
+    CNIT_ASSERT(bvec_sum(b) == sum);
+    CNIT_ASSERT(dvec_min(d) == -500.5);
+    CNIT_ASSERT(dvec_max(d) == 499.5);
+    dvec_erase(d, 0);
+    CNIT_ASSERT(dvec_min(d) == -500.5 + 1);
+    dvec_clear(d);
+    CNIT_ASSERT(dvec_sum(d) == 0);
+    bvec_free(b);
+    dvec_free(d);
+    return 0;
+}
+
+static bool is_odd(int e, void *ctx) {
+    (void) ctx;
+    return e % 2 != 0;
+}
+
+int test_range_ops() {
+    ivec *v = ivec_new();
+    int arr[TEST_COUNT];
+    for (int i = 0; i < TEST_COUNT; i++) {
+        arr[i] = i;
+    }
+    /* 0, ..., TEST_COUNT - 1, then 0, ..., TEST_COUNT - 1 */
+    ivec_append_array(v, arr, TEST_COUNT);
+    ivec_append_array(v, arr, TEST_COUNT);
+    CNIT_ASSERT(v->size == 2 * TEST_COUNT);
+    ivec_erase_range(v, TEST_COUNT, TEST_COUNT);
+    CNIT_ASSERT(v->size == TEST_COUNT);
+    /* 0, 1, 2, [0, ..., 9], 3, ..., TEST_COUNT - 1 */
+    ivec_insert_range(v, 3, arr, 10);
+    CNIT_ASSERT(v->size == TEST_COUNT + 10);
+    for (int i = 0; i < TEST_COUNT + 10; i++) {
+        CNIT_ASSERT(ivec_at(v, i) == (i < 3 ? i : i < 13 ? i - 3 : i - 10));
+    }
+    ivec_erase_range(v, 3, 10);
+    CNIT_ASSERT(ivec_remove_if(v, is_odd, NULL) == TEST_COUNT / 2);
+    for (int i = 0; i < TEST_COUNT / 2; i++) {
+        CNIT_ASSERT(ivec_at(v, i) == 2 * i);
+    }
+    CNIT_ASSERT(ivec_swap_remove(v, 0) == 0);
+    CNIT_ASSERT(ivec_at(v, 0) == TEST_COUNT - 2);
+    CNIT_ASSERT(v->size == TEST_COUNT / 2 - 1);
+    ivec_resize(v, 2, 0);
+    ivec_resize(v, 5, -1);
+    CNIT_ASSERT(v->size == 5);
+    CNIT_ASSERT(ivec_at(v, 1) == 2 && ivec_at(v, 2) == -1 && ivec_at(v, 4) == -1);
+    ivec_free(v);
+    return 0;
+}
+
+static uint64_t rand_state = 12345;
+
+static uint64_t next_rand() {
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 7;
+    rand_state ^= rand_state << 17;
+    return rand_state;
+}
+
+int test_sort() {
+    ivec *v = ivec_new();
+    lvec *l = lvec_new();
+    ptvec *pt = ptvec_new();
+    /* random, few distinct, sorted and reversed inputs */
+    for (int kind = 0; kind < 4; kind++) {
+        ivec_clear(v);
+        lvec_clear(l);
+        ptvec_clear(pt);
+        for (int i = 0; i < 20 * TEST_COUNT; i++) {
+            int64_t r = (int64_t) next_rand();
+            int value = kind == 0 ? (int) r : kind == 1 ? (int) (r & 7) - 4 : kind == 2 ? i : -i;
+            ivec_push_back(v, value);
+            lvec_push_back(l, kind == 0 ? r : value);
+            ptvec_push_back(pt, (struct point) { value % 10, i });
+        }
+        uint64_t checksum = 0;
+        for (size_t i = 0; i < l->size; i++) {
+            checksum += (uint64_t) l->array[i] * 0x9e3779b97f4a7c15u;
+        }
+        ivec_sort(v);
+        lvec_radix_sort(l);
+        ptvec_sort(pt);
+        for (size_t i = 1; i < v->size; i++) {
+            CNIT_ASSERT(v->array[i - 1] <= v->array[i]);
+            CNIT_ASSERT(l->array[i - 1] <= l->array[i]);
+            CNIT_ASSERT(pt->array[i - 1].x < pt->array[i].x ||
+                        (pt->array[i - 1].x == pt->array[i].x && pt->array[i - 1].y < pt->array[i].y));
+        }
+        for (size_t i = 0; i < l->size; i++) {
+            checksum -= (uint64_t) l->array[i] * 0x9e3779b97f4a7c15u;
+        }
+        CNIT_ASSERT(checksum == 0);
+    }
+    ivec_free(v);
+    lvec_free(l);
+    ptvec_free(pt);
+    return 0;
+}
+
+int test_radix_sort() {
+    bvec *b = bvec_new();
+    fvec *f = fvec_new();
+    dvec *d = dvec_new();
+    for (int i = 0; i < TEST_COUNT; i++) {
+        bvec_push_back(b, (uint8_t) next_rand());
+        fvec_push_back(f, (float) ((int) (next_rand() % 2001) - 1000) / 8);
+        dvec_push_back(d, (double) (int64_t) next_rand() / 3);
+    }
+    fvec_push_back(f, -0.0f);
+    bvec_radix_sort(b);
+    fvec_radix_sort(f);
+    dvec_radix_sort(d);
+    for (int i = 1; i < TEST_COUNT; i++) {
+        CNIT_ASSERT(b->array[i - 1] <= b->array[i]);
+        CNIT_ASSERT(d->array[i - 1] <= d->array[i]);
+    }
+    for (int i = 1; i < f->size; i++) {
+        CNIT_ASSERT(f->array[i - 1] <= f->array[i]);
+    }
+    CNIT_ASSERT(f->array[0] < 0 && f->array[f->size - 1] > 0);
+    bvec_free(b);
+    fvec_free(f);
+    dvec_free(d);
+    return 0;
+}
+
+int test_sorted_ops() {
+    ivec *a = ivec_new(), *b = ivec_new(), *dst = ivec_new();
+    /* a: multiples of 2 (with 6 twice), b: multiples of 3 */
+    for (int i = 0; i < TEST_COUNT; i++) {
+        ivec_push_back(a, 2 * i);
+        if (i == 3) {
+            ivec_push_back(a, 6);
+        }
+        ivec_push_back(b, 3 * i);
+    }
+    CNIT_ASSERT(ivec_lower_bound(a, 6) == 3);
+    CNIT_ASSERT(ivec_upper_bound(a, 6) == 5);
+    CNIT_ASSERT(ivec_lower_bound(a, 7) == 5);
+    CNIT_ASSERT(ivec_lower_bound(a, -1) == 0);
+    CNIT_ASSERT(ivec_upper_bound(a, 1 << 20) == a->size);
+    CNIT_ASSERT(ivec_binary_search(a, 8));
+    CNIT_ASSERT(!ivec_binary_search(a, 9));
+
+    ivec_merge(dst, a, b);
+    CNIT_ASSERT(dst->size == a->size + b->size);
+    for (size_t i = 1; i < dst->size; i++) {
+        CNIT_ASSERT(dst->array[i - 1] <= dst->array[i]);
+    }
+    ivec_intersection(dst, a, b);
+    for (size_t i = 0; i < dst->size; i++) {
+        CNIT_ASSERT(dst->array[i] == 6 * (int) i);
+    }
+    CNIT_ASSERT(dst->size == (2 * TEST_COUNT + 5) / 6);
+    ivec_union(dst, a, b);
+    size_t expected = 0;
+    for (int i = 0; i < 3 * TEST_COUNT; i++) {
+        expected += (i % 2 == 0 && i < 2 * TEST_COUNT) || i % 3 == 0;
+    }
+    CNIT_ASSERT(dst->size == expected + 1);
+    CNIT_ASSERT(ivec_count(dst, 6) == 2);
+    ivec_free(a);
+    ivec_free(b);
+    ivec_free(dst);
+    return 0;
+}
+
+int test_inline_capacity() {
+    size_t live = 0;
+    smallvec v;
+    smallvec_init(&v, &live);
+    /* the first 4 elements do not touch the heap */
+    for (int i = 0; i < 4; i++) {
+        smallvec_push_back(&v, i);
+    }
+    CNIT_ASSERT(live == 0);
+    CNIT_ASSERT(smallvec_find(&v, 3) == 3);
+    for (int i = 4; i < TEST_COUNT; i++) {
+        smallvec_push_back(&v, i);
+    }
+    CNIT_ASSERT(live == v.capacity * sizeof(int));
+    for (int i = 0; i < TEST_COUNT; i++) {
+        CNIT_ASSERT(smallvec_at(&v, i) == i);
+    }
+    smallvec_destroy(&v);
+    CNIT_ASSERT(live == 0);
+
+    smallvec *heap = smallvec_new_with_ctx(&live);
+    smallvec_push_back(heap, 1);
+    CNIT_ASSERT(live == sizeof(smallvec));
+    smallvec_free(heap);
+    CNIT_ASSERT(live == 0);
+    return 0;
+}
+
+int test_shrink_to_fit() {
+    size_t live = 0;
+    cvec *v = cvec_new_with_ctx(&live);
+    for (int i = 0; i < TEST_COUNT; i++) {
+        cvec_push_back(v, i);
+    }
+    cvec_erase_range(v, 10, TEST_COUNT - 10);
+    cvec_shrink_to_fit(v);
+    CNIT_ASSERT(v->capacity == 10);
+    CNIT_ASSERT(live == sizeof(cvec) + 10 * sizeof(long));
+    for (int i = 0; i < 10; i++) {
+        CNIT_ASSERT(cvec_at(v, i) == i);
+    }
+    cvec_clear(v);
+    cvec_shrink_to_fit(v);
+    CNIT_ASSERT(v->capacity > 0);
+    cvec_push_back(v, 3);
+    cvec_free(v);
+    CNIT_ASSERT(live == 0);
+
+    /* a vector with inline storage moves back into it */
+    smallvec s;
+    smallvec_init(&s, &live);
+    for (int i = 0; i < TEST_COUNT; i++) {
+        smallvec_push_back(&s, i);
+    }
+    smallvec_resize(&s, 3, 0);
+    smallvec_shrink_to_fit(&s);
+    CNIT_ASSERT(live == 0);
+    CNIT_ASSERT(s.array == s.inline_array && s.capacity == 4);
+    CNIT_ASSERT(smallvec_at(&s, 2) == 2);
+    smallvec_shrink_to_fit(&s);
+    smallvec_destroy(&s);
+    return 0;
+}
+
 int main() {
     cnit_add_test(test_sanity, "Vector sanity test");
     cnit_add_test(test_stack_ops, "Vector stack operations (push/pop)");
     cnit_add_test(test_insert_erase, "Vector insert/erase operations");
+    cnit_add_test(test_allocator_hooks, "Vector allocator hooks");
+    cnit_add_test(test_search, "Vector find/rfind/count/contains");
+    cnit_add_test(test_reductions, "Vector min/max/sum");
+    cnit_add_test(test_inline_capacity, "Vector inline capacity");
+    cnit_add_test(test_range_ops, "Vector range operations");
+    cnit_add_test(test_sort, "Vector introsort");
+    cnit_add_test(test_radix_sort, "Vector radix sort");
+    cnit_add_test(test_sorted_ops, "Vector binary search and sorted-set operations");
+    cnit_add_test(test_shrink_to_fit, "Vector shrink_to_fit");
     return cnit_run_tests();
 }
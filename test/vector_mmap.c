@@ -0,0 +1,86 @@
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdint.h>
+
+#define cgs_vec_type int64_t
+#define cgs_vec_name mlvec
+#define cgs_vec_integral
+#define cgs_vec_mmap
+#include "cgs_vector.h"
+#define cgs_mlvec 1
+
+#define cgs_vec_type int32_t
+#define cgs_vec_name mivec
+#define cgs_vec_mmap
+#include "cgs_vector.h"
+#define cgs_mivec 1
+
+#include "cnit/cnit_main.h"
+#define TEST_COUNT 100000
+
+int test_mmap_anonymous() {
+    mlvec *v = mlvec_new();
+    for (int i = 0; i < TEST_COUNT; i++) {
+        mlvec_push_back(v, i);
+    }
+    CNIT_ASSERT(mlvec_advise(v, MADV_SEQUENTIAL));
+    CNIT_ASSERT(mlvec_sum(v) == (int64_t) TEST_COUNT * (TEST_COUNT - 1) / 2);
+    CNIT_ASSERT(mlvec_find(v, 1234) == 1234);
+    mlvec_resize(v, 10, 0);
+    mlvec_shrink_to_fit(v);
+    CNIT_ASSERT(v->capacity == 10);
+    for (int i = 0; i < 10; i++) {
+        CNIT_ASSERT(mlvec_at(v, i) == i);
+    }
+    CNIT_ASSERT(mlvec_sync(v, true));
+    mlvec_free(v);
+    return 0;
+}
+
+int test_mmap_file() {
+    char path[64];
+    snprintf(path, sizeof(path), "/tmp/cgs_test_vector_mmap_%d", (int) getpid());
+    unlink(path);
+
+    mlvec v;
+    CNIT_ASSERT(mlvec_init_file(&v, path, NULL));
+    CNIT_ASSERT(v.size == 0);
+    for (int i = 0; i < TEST_COUNT; i++) {
+        mlvec_push_back(&v, (int64_t) i * i);
+    }
+    CNIT_ASSERT(mlvec_sync(&v, true));
+    mlvec_destroy(&v);
+
+    /* reopening finds the elements in the file */
+    CNIT_ASSERT(mlvec_init_file(&v, path, NULL));
+    CNIT_ASSERT(v.size == TEST_COUNT);
+    CNIT_ASSERT(mlvec_advise(&v, MADV_RANDOM));
+    for (int i = 0; i < TEST_COUNT; i++) {
+        CNIT_ASSERT(mlvec_at(&v, i) == (int64_t) i * i);
+    }
+    mlvec_erase_range(&v, 0, TEST_COUNT - 5);
+    mlvec_shrink_to_fit(&v);
+    mlvec_destroy(&v);
+
+    CNIT_ASSERT(mlvec_init_file(&v, path, NULL));
+    CNIT_ASSERT(v.size == 5 && v.capacity == 8);
+    CNIT_ASSERT(mlvec_at(&v, 0) == (int64_t) (TEST_COUNT - 5) * (TEST_COUNT - 5));
+    mlvec_destroy(&v);
+
+    /* a vector of another element size starts over */
+    mivec w;
+    CNIT_ASSERT(mivec_init_file(&w, path, NULL));
+    CNIT_ASSERT(w.size == 0);
+    mivec_push_back(&w, 42);
+    mivec_destroy(&w);
+
+    CNIT_ASSERT(!mlvec_init_file(&v, "/nonexistent/cgs_test_vector_mmap", NULL));
+    unlink(path);
+    return 0;
+}
+
+int main() {
+    cnit_add_test(test_mmap_anonymous, "Memory-mapped vector in anonymous memory");
+    cnit_add_test(test_mmap_file, "Memory-mapped vector in a file");
+    return cnit_run_tests();
+}